@@ -0,0 +1,191 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "allocationguard.h"
+
+#ifdef DEBUG
+
+#include <algorithm>
+#include <assert.h>
+#include <stdlib.h>
+#include <new>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+// replacements of the global allocation functions which trap any allocation
+// made while an AllocationGuard is active on the current thread (e.g. inside
+// the audio callback), the memory itself is managed by malloc and free
+// the sized and aligned variants (when available to the language standard in use) are
+// replaced too, as the compiler picks these for over-aligned types and sized deallocation
+// the plugin is linked with -Bsymbolic in debug builds (see the Makefile) so its
+// allocations use these functions rather than those of the host's C++ runtime
+
+static thread_local bool allocated = false; // set upon each allocation, see isTrapping()
+
+bool Igorski::AllocationGuard::isTrapping()
+{
+    allocated = false;
+    ::operator delete( ::operator new( 1 ));
+
+    return allocated;
+}
+
+void* operator new( size_t size )
+{
+    assert( !Igorski::AllocationGuard::isActive() && "heap allocation inside the process cycle" );
+    allocated = true;
+
+    void* memory = malloc( size > 0 ? size : 1 );
+    if ( memory == nullptr ) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void* operator new[]( size_t size )
+{
+    return operator new( size );
+}
+
+void* operator new( size_t size, const std::nothrow_t& ) noexcept
+{
+    assert( !Igorski::AllocationGuard::isActive() && "heap allocation inside the process cycle" );
+    allocated = true;
+
+    return malloc( size > 0 ? size : 1 );
+}
+
+void* operator new[]( size_t size, const std::nothrow_t& tag ) noexcept
+{
+    return operator new( size, tag );
+}
+
+void operator delete( void* memory ) noexcept
+{
+    free( memory );
+}
+
+void operator delete[]( void* memory ) noexcept
+{
+    free( memory );
+}
+
+void operator delete( void* memory, const std::nothrow_t& ) noexcept
+{
+    free( memory );
+}
+
+void operator delete[]( void* memory, const std::nothrow_t& ) noexcept
+{
+    free( memory );
+}
+
+#if __cpp_sized_deallocation
+
+void operator delete( void* memory, size_t ) noexcept
+{
+    free( memory );
+}
+
+void operator delete[]( void* memory, size_t ) noexcept
+{
+    free( memory );
+}
+
+#endif
+
+#if __cpp_aligned_new
+
+void* operator new( size_t size, std::align_val_t alignment, const std::nothrow_t& ) noexcept
+{
+    assert( !Igorski::AllocationGuard::isActive() && "heap allocation inside the process cycle" );
+    allocated = true;
+
+    size_t align = std::max( static_cast<size_t>( alignment ), sizeof( void* ));
+    size = size > 0 ? size : 1;
+#ifdef _WIN32
+    return _aligned_malloc( size, align );
+#else
+    void* memory;
+    return posix_memalign( &memory, align, size ) == 0 ? memory : nullptr;
+#endif
+}
+
+void* operator new( size_t size, std::align_val_t alignment )
+{
+    void* memory = operator new( size, alignment, std::nothrow );
+    if ( memory == nullptr ) {
+        throw std::bad_alloc();
+    }
+    return memory;
+}
+
+void* operator new[]( size_t size, std::align_val_t alignment )
+{
+    return operator new( size, alignment );
+}
+
+void* operator new[]( size_t size, std::align_val_t alignment, const std::nothrow_t& tag ) noexcept
+{
+    return operator new( size, alignment, tag );
+}
+
+// memory obtained through _aligned_malloc must be released by _aligned_free
+
+void operator delete( void* memory, std::align_val_t ) noexcept
+{
+#ifdef _WIN32
+    _aligned_free( memory );
+#else
+    free( memory );
+#endif
+}
+
+void operator delete[]( void* memory, std::align_val_t alignment ) noexcept
+{
+    operator delete( memory, alignment );
+}
+
+void operator delete( void* memory, std::align_val_t alignment, const std::nothrow_t& ) noexcept
+{
+    operator delete( memory, alignment );
+}
+
+void operator delete[]( void* memory, std::align_val_t alignment, const std::nothrow_t& ) noexcept
+{
+    operator delete( memory, alignment );
+}
+
+void operator delete( void* memory, size_t, std::align_val_t alignment ) noexcept
+{
+    operator delete( memory, alignment );
+}
+
+void operator delete[]( void* memory, size_t, std::align_val_t alignment ) noexcept
+{
+    operator delete( memory, alignment );
+}
+
+#endif
+
+#endif
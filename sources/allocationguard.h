@@ -1,7 +1,7 @@
 /**
  * The MIT License (MIT)
  *
- * Based on freeverb by Jezar at Dreampoint (June 2000)
+ * Copyright (c) 2019 Igor Zinken - https://www.igorski.nl
  *
  * Permission is hereby granted, free of charge, to any person obtaining a copy of
  * this software and associated documentation files (the "Software"), to deal in
@@ -20,46 +20,43 @@
  * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
  * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
-#ifndef __COMB_H_INCLUDED__
-#define __COMB_H_INCLUDED__
-
-#include "global.h"
-#include "calc.h"
+#ifndef __ALLOCATIONGUARD_H_INCLUDED__
+#define __ALLOCATIONGUARD_H_INCLUDED__
 
 namespace Igorski {
-class Comb
+/**
+ * AllocationGuard marks the scope it lives in as real-time critical. In debug
+ * builds, any heap allocation made through operator new (including its aligned
+ * variants) or an Arena by the thread holding the guard triggers an assertion
+ * (see allocationguard.cpp). Allocations made directly through malloc are not trapped.
+ * In release builds the guard does nothing
+ */
+class AllocationGuard
 {
     public:
-        Comb();
-        void setBuffer( float *buf, int size );
-        inline float process( float input )
-        {
-            float output = _buffer[ _bufIndex ];
-            undenormalise( output );
+#ifdef DEBUG
+        AllocationGuard()  { ++depth(); }
+        ~AllocationGuard() { --depth(); }
 
-            _filterStore = ( output * _damp2 ) + ( _filterStore * _damp1 );
-            undenormalise( _filterStore );
+        static bool isActive() { return depth() > 0; }
 
-            _buffer[_bufIndex] = input + ( _filterStore * _feedback );
-            if ( ++_bufIndex >= _bufSize ) {
-                _bufIndex = 0;
-            }
-            return output;
-        }
-        void mute();
-        float getDamp();
-        void setDamp( float val );
-        float getFeedback();
-        void setFeedback( float val );
+        // whether operator new of allocationguard.cpp is in use by this binary, when
+        // loaded as a shared library it can otherwise bind to that of the C++ runtime
+
+        static bool isTrapping();
 
     private:
-        float  _feedback;
-        float  _filterStore;
-        float  _damp1;
-        float  _damp2;
-        float* _buffer;
-        int _bufSize;
-        int _bufIndex;
+        static int& depth()
+        {
+            static thread_local int value = 0;
+            return value;
+        }
+#else
+        AllocationGuard() {}
+
+        static bool isActive() { return false; }
+#endif
 };
 }
+
 #endif
@@ -20,41 +20,47 @@
  * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
  * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
-#ifndef __ALLPASS_H_INCLUDED__
-#define __ALLPASS_H_INCLUDED__
+#ifndef __ALLPASSCHAIN_H_INCLUDED__
+#define __ALLPASSCHAIN_H_INCLUDED__
 
 #include "global.h"
-#include "calc.h"
+#include <array>
 
 namespace Igorski {
-class AllPass
+/**
+ * AllPassChain holds the series of all pass filters of all reverb channels
+ * blocks are processed one stage at a time: each stage streams over the
+ * whole block (for every channel) before the next stage is run on its output
+ */
+template <int Channels, int Stages = VST::NUM_ALLPASSES>
+class AllPassChain
 {
     public:
-        AllPass();
-        void setBuffer( float *buf, int size );
-        inline float process( float input )
-        {
-            float output;
-            float bufout = _buffer[ _bufIndex ];
-            undenormalise( bufout );
-
-            output = -input + bufout;
-            _buffer[ _bufIndex ] = input + ( bufout * _feedback );
-
-            if ( ++_bufIndex >= _bufSize ) {
-                _bufIndex = 0;
-            }
-            return output;
-        }
+        static const int LANES = Channels * Stages;
+
+        AllPassChain();
+        void setBuffer( int channel, int stage, float *buf, int size );
+
+        // process a block of samples for all channels, in and out may point to the same
+        // buffers, each stage is applied in parts that never wrap around its delay line
+        // (and thus never read back a value written within the same part)
+
+        void processBlock( float** in, float** out, int n );
+
         void mute();
         float getFeedback();
         void setFeedback( float val );
 
     private:
-        float  _feedback;
-        float* _buffer;
-        int _bufSize;
-        int _bufIndex;
+        float _feedback;
+        std::array<float*, LANES> _buffers;
+        std::array<int,    LANES> _bufSizes;
+        std::array<int,    LANES> _bufIndices;
+
+        void processStage( int stage, const float* in, float* out, int n );
 };
 }
+
+#include "allpasschain.tcc"
+
 #endif
@@ -0,0 +1,119 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Based on freeverb by Jezar at Dreampoint (June 2000)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+ #include "simd.h"
+ #include <algorithm>
+
+ namespace Igorski {
+
+ template <int Channels, int Stages>
+ AllPassChain<Channels, Stages>::AllPassChain()
+ {
+     _buffers.fill( nullptr );
+     _bufSizes.fill( 0 );
+     _bufIndices.fill( 0 );
+
+     setFeedback( 0.5f );
+ }
+
+ template <int Channels, int Stages>
+ void AllPassChain<Channels, Stages>::setBuffer( int channel, int stage, float *buf, int size )
+ {
+     stage += channel * Stages;
+
+     _buffers [ stage ] = buf;
+     _bufSizes[ stage ] = size;
+ }
+
+ template <int Channels, int Stages>
+ void AllPassChain<Channels, Stages>::processBlock( float** in, float** out, int n )
+ {
+     for ( int s = 0; s < Stages; ++s ) {
+         for ( int c = 0; c < Channels; ++c ) {
+             processStage( c * Stages + s, ( s == 0 ) ? in[ c ] : out[ c ], out[ c ], n );
+         }
+     }
+ }
+
+ template <int Channels, int Stages>
+ void AllPassChain<Channels, Stages>::mute()
+ {
+     for ( int s = 0; s < LANES; ++s ) {
+         for ( int i = 0; i < _bufSizes[ s ]; ++i ) {
+             _buffers[ s ][ i ] = 0;
+         }
+     }
+ }
+
+ template <int Channels, int Stages>
+ float AllPassChain<Channels, Stages>::getFeedback()
+ {
+     return _feedback;
+ }
+
+ template <int Channels, int Stages>
+ void AllPassChain<Channels, Stages>::setFeedback( float val )
+ {
+     _feedback = val;
+ }
+
+ /* private methods */
+
+ template <int Channels, int Stages>
+ void AllPassChain<Channels, Stages>::processStage( int stage, const float* in, float* out, int n )
+ {
+     float* buffer = _buffers[ stage ];
+     int size      = _bufSizes[ stage ];
+     int index     = _bufIndices[ stage ];
+
+     SIMD::vfloat feedback = SIMD::set1( _feedback );
+
+     while ( n > 0 )
+     {
+         int length   = std::min( n, size - index );
+         float* write = buffer + index;
+         int i = 0;
+
+         for ( ; i + SIMD::WIDTH <= length; i += SIMD::WIDTH ) {
+             SIMD::vfloat input  = SIMD::load( in + i );
+             SIMD::vfloat bufout = SIMD::load( write + i );
+             SIMD::store( write + i, SIMD::madd( bufout, feedback, input ));
+             SIMD::store( out + i, SIMD::sub( bufout, input ));
+         }
+         for ( ; i < length; ++i ) {
+             float input  = in[ i ];
+             float bufout = write[ i ];
+             write[ i ] = input + ( bufout * _feedback );
+             out[ i ]   = -input + bufout;
+         }
+
+         if (( index += length ) >= size ) {
+             index = 0;
+         }
+         in  += length;
+         out += length;
+         n   -= length;
+     }
+     _bufIndices[ stage ] = index;
+ }
+
+ }
@@ -0,0 +1,103 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "arena.h"
+#include "allocationguard.h"
+#include <assert.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+namespace Igorski {
+
+Arena::Arena()
+{
+    _allocation = nullptr;
+    _memory     = nullptr;
+    _size       = 0;
+    _offset     = 0;
+}
+
+Arena::~Arena()
+{
+    release();
+}
+
+/* public methods */
+
+size_t Arena::align( size_t bytes )
+{
+    return ( bytes + ( ALIGNMENT - 1 )) & ~( ALIGNMENT - 1 );
+}
+
+void Arena::allocate( size_t bytes )
+{
+    assert( !AllocationGuard::isActive() && "heap allocation inside the process cycle" );
+
+    release();
+
+    _size = align( bytes );
+
+    if ( _size == 0 )
+        return;
+
+    // over-allocate so the start of the arena can be moved onto an aligned address
+
+    _allocation = ( char* ) malloc( _size + ALIGNMENT );
+
+    if ( _allocation == nullptr ) {
+        _size = 0;
+        return;
+    }
+    _memory = ( char* )((( uintptr_t ) _allocation + ( ALIGNMENT - 1 )) & ~( uintptr_t ) ( ALIGNMENT - 1 ));
+    memset( _memory, 0, _size );
+}
+
+void Arena::release()
+{
+    free( _allocation );
+
+    _allocation = nullptr;
+    _memory     = nullptr;
+    _size       = 0;
+    _offset     = 0;
+}
+
+void* Arena::take( size_t bytes )
+{
+    bytes = align( bytes );
+
+    if ( _offset + bytes > _size )
+        return nullptr;
+
+    void* portion = _memory + _offset;
+    _offset += bytes;
+
+    return portion;
+}
+
+size_t Arena::getSize()
+{
+    return _size;
+}
+
+}
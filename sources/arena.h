@@ -0,0 +1,77 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __ARENA_H_INCLUDED__
+#define __ARENA_H_INCLUDED__
+
+#include <stddef.h>
+
+namespace Igorski {
+/**
+ * An Arena is a single heap allocation that is handed out in cache line
+ * aligned portions. Objects that are used together are laid out back to
+ * back and are freed all at once when the arena is released.
+ *
+ * Memory taken from the arena is zeroed. Objects placed inside the arena
+ * do not have their destructors run upon release.
+ */
+class Arena
+{
+    public:
+        static const size_t ALIGNMENT = 64;
+
+        Arena();
+        ~Arena();
+
+        // round given amount of bytes up to a multiple of ALIGNMENT, sum
+        // the aligned sizes of all portions to know the size to allocate
+
+        static size_t align( size_t bytes );
+
+        // (re)allocates the arena to hold given amount of bytes
+        // memory taken from a previous allocation is no longer valid
+
+        void allocate( size_t bytes );
+        void release();
+
+        // take the next portion of given size from the arena
+        // returns nullptr when the arena has insufficient space left
+
+        void* take( size_t bytes );
+
+        template <typename T>
+        T* take( size_t count )
+        {
+            return static_cast<T*>( take( count * sizeof( T )));
+        }
+
+        size_t getSize();
+
+    private:
+        char*  _allocation; // as returned by malloc
+        char*  _memory;     // aligned start of the arena
+        size_t _size;
+        size_t _offset;
+};
+}
+
+#endif
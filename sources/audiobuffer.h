@@ -24,32 +24,33 @@
 #define __AUDIOBUFFER_H_INCLUDED__
 
 #include "global.h"
-#include <vector>
+#include <stddef.h>
 
+namespace Igorski {
 /**
- * An AudioBuffer represents multiple channels of audio
- * each of equal buffer length.
- * AudioBuffer has convenience methods for cloning, silencing and mixing
+ * A non-owning view onto multiple channels of audio of equal buffer length, the
+ * channels are spaced stride samples apart. Views are cheap to copy so process
+ * code can pass them around by value
  */
-class AudioBuffer
+struct AudioBufferView
 {
-    public:
-        AudioBuffer( int aAmountOfChannels, int aBufferSize );
-        ~AudioBuffer();
+    float* data;
+    int amountOfChannels;
+    int bufferSize;
+    size_t stride; // in samples
 
-        int amountOfChannels;
-        int bufferSize;
-        bool loopeable;
+    inline float* getChannel( int aChannelNum ) const
+    {
+        return data + aChannelNum * stride;
+    }
 
-        float* getBufferForChannel( int aChannelNum );
-        int mergeBuffers( AudioBuffer* aBuffer, int aReadOffset, int aWriteOffset, float aMixVolume );
-        void silenceBuffers();
-        void adjustBufferVolumes( float volume );
-        bool isSilent();
-        AudioBuffer* clone();
+    // view onto given range of samples of each channel
 
-    protected:
-        std::vector<float*>* _buffers;
+    inline AudioBufferView slice( int aOffset, int aLength ) const
+    {
+        return { data + aOffset, amountOfChannels, aLength, stride };
+    }
 };
+}
 
 #endif
@@ -23,14 +23,18 @@
 #include "bitcrusher.h"
 #include "global.h"
 #include "calc.h"
+#include "simd.h"
+#include <algorithm>
 #include <limits.h>
 #include <math.h>
 
 namespace Igorski {
 
+const int BitCrusher::CONTROL_RATE;
+
 /* constructor */
 
-BitCrusher::BitCrusher( float amount, float inputMix, float outputMix, float sampleRate )
+BitCrusher::BitCrusher( float amount, float inputMix, float outputMix, float sampleRate ) : lfo( sampleRate )
 {
     // jpc: resolve use of uninitialized memory
     hasLFO = false;
@@ -43,13 +47,11 @@ BitCrusher::BitCrusher( float amount, float inputMix, float outputMix, float sam
     setOutputMix( outputMix );
 
     _tempAmount = _amount;
-
-    lfo = new LFO( sampleRate );
 }
 
 BitCrusher::~BitCrusher()
 {
-    delete lfo;
+    // nowt...
 }
 
 /* public methods */
@@ -64,7 +66,7 @@ void BitCrusher::setLFO( float LFORatePercentage, float LFODepth )
     bool hadChange = ( wasEnabled != enabled ) || _lfoDepth != LFODepth;
 
     if ( enabled )
-        lfo->setRate(
+        lfo.setRate(
             VST::MIN_LFO_RATE() + (
                 LFORatePercentage * ( VST::MAX_LFO_RATE() - VST::MIN_LFO_RATE() )
             )
@@ -82,33 +84,66 @@ void BitCrusher::setLFO( float LFORatePercentage, float LFODepth )
     }
 }
 
-void BitCrusher::process( float* inBuffer, int bufferSize )
+void BitCrusher::process( float* inBuffer, int bufferSize, const float* modulation )
 {
     // sound should not be crushed ? do nothing
-    if ( _bits == 16 && !hasLFO )
+    if ( !isActive() )
         return;
 
-    int bitsPlusOne = _bits + 1;
+    // the input is scaled to the 16-bit range (clamped as it is not wrapped around)
+    // after which the bits below the current resolution are masked off. The offset
+    // of the original implementation ( -1 >> bits ) always equals -1
+
+    const float inputScale  = _inputMix * SHRT_MAX;
+    const float outputScale = _outputMix / SHRT_MAX;
+
+    const SIMD::vfloat vInputScale  = SIMD::set1( inputScale );
+    const SIMD::vfloat vOutputScale = SIMD::set1( outputScale );
+    const SIMD::vfloat vMin         = SIMD::set1( ( float ) SHRT_MIN );
+    const SIMD::vfloat vMax         = SIMD::set1( ( float ) SHRT_MAX );
+    const SIMD::vfloat vOffset      = SIMD::set1( 1.f );
 
-    for ( int i = 0; i < bufferSize; ++i )
+    for ( int offset = 0; offset < bufferSize; offset += CONTROL_RATE )
     {
-        short input = ( short ) (( inBuffer[ i ] * _inputMix ) * SHRT_MAX );
-        short prevent_offset = ( short )( -1 >> bitsPlusOne );
-        input &= ( -1 << ( 16 - _bits ));
-        inBuffer[ i ] = (( input + prevent_offset ) * _outputMix ) / SHRT_MAX;
+        int length = std::min( CONTROL_RATE, bufferSize - offset );
 
         if ( hasLFO ) {
             // multiply by .5 and add .5 to make the LFO's bipolar waveform unipolar
-            float lfoValue = lfo->peek() * .5f  + .5f;
+            float lfoValue = modulation[ offset ] * .5f  + .5f;
             _tempAmount = std::min( _lfoMax, _lfoMin + _lfoRange * lfoValue );
 
             // recalculate the current resolution
             calcBits();
-            bitsPlusOne = _bits + 1;
+        }
+
+        int mask = ( int ) ( ~0u << ( 16 - _bits ));
+        const SIMD::vint vMask = SIMD::set1Int( mask );
+
+        float* buffer = inBuffer + offset;
+        int i = 0;
+
+        for ( ; i + SIMD::WIDTH <= length; i += SIMD::WIDTH )
+        {
+            SIMD::vfloat input = SIMD::mul( SIMD::load( buffer + i ), vInputScale );
+            input = SIMD::min( vMax, SIMD::max( vMin, input ));
+
+            SIMD::vfloat crushed = SIMD::toFloat( SIMD::bitAnd( SIMD::toInt( input ), vMask ));
+            SIMD::store( buffer + i, SIMD::mul( SIMD::sub( crushed, vOffset ), vOutputScale ));
+        }
+
+        for ( ; i < length; ++i )
+        {
+            float input = std::min( ( float ) SHRT_MAX, std::max( ( float ) SHRT_MIN, buffer[ i ] * inputScale ));
+            buffer[ i ] = (( float ) (( int ) input & mask ) - 1.f ) * outputScale;
         }
     }
 }
 
+bool BitCrusher::isActive()
+{
+    return _bits < 16 || hasLFO;
+}
+
 /* setters */
 
 void BitCrusher::setAmount( float value )
@@ -29,17 +29,26 @@ namespace Igorski {
 class BitCrusher {
 
     public:
+        static const int CONTROL_RATE = 32;
+
         BitCrusher( float amount, float inputMix, float outputMix, float sampleRate );
         ~BitCrusher();
 
         void setLFO( float LFORatePercentage, float LFODepth );
-        void process( float* inBuffer, int bufferSize );
+        // the values of the LFO for the block are provided by the caller (see ModulationBus)
+        // while modulated, the resolution is updated once every CONTROL_RATE samples
+
+        void process( float* inBuffer, int bufferSize, const float* modulation );
+
+        // whether process() alters the signal at the current settings
+
+        bool isActive();
 
         void setAmount( float value ); // range between -1 to +1
         void setInputMix( float value );
         void setOutputMix( float value );
 
-        LFO* lfo;
+        LFO lfo; // configured by the bit crusher, rendered by the ModulationBus
         bool hasLFO;
 
     private:
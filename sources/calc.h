@@ -27,10 +27,6 @@
 #include <algorithm>
 #include "global.h"
 
-// internally we handle all audio as 32-bit floats (hence 0x7f800000)
-// this methods is used by comb and allpass
-#define undenormalise(sample) ((((*(uint32 *)&(sample))&0x7f800000)==0)&&((sample)!=0.f))
-
 /**
  * convenience utilities to process values
  * common to the VST plugin context
@@ -56,6 +52,15 @@ namespace Calc {
         return secondsToBuffer( milliseconds / 1000.f, sampleRate );
     }
 
+    /**
+     * convert given amount of samples to the appropriate
+     * duration in milliseconds (for the current sampling rate)
+     */
+    inline float bufferToMilliseconds( int bufferSize, float sampleRate )
+    {
+        return ( float ) bufferSize / sampleRate * 1000.f;
+    }
+
     // convenience method to ensure given value is within the 0.f - +1.f range
 
     inline float cap( float value )
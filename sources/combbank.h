@@ -0,0 +1,77 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Based on freeverb by Jezar at Dreampoint (June 2000)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __COMBBANK_H_INCLUDED__
+#define __COMBBANK_H_INCLUDED__
+
+#include "global.h"
+#include "simd.h"
+#include <array>
+
+namespace Igorski {
+/**
+ * CombBank runs all parallel comb filters of all reverb channels in lockstep
+ * the per-comb state is kept as structure-of-arrays where the combs of a channel
+ * occupy adjacent lanes, so each frame updates the damping and feedback of every
+ * comb of every channel in as few vector operations as possible
+ */
+template <int Channels, int Combs = VST::NUM_COMBS>
+class CombBank
+{
+    public:
+        static const int LANES = Channels * Combs;
+
+        CombBank();
+        void setBuffer( int channel, int comb, float *buf, int size );
+
+        // process a block of samples for all channels, in and out may point to the
+        // same buffers as the block is processed in parts no longer than the shortest delay
+        // line (a part never reads back its own writes), the delay lines are read and written
+        // per comb while the damping recursion runs across all lanes in lockstep
+
+        void processBlock( float** in, float** out, int n );
+
+        void mute();
+        float getDamp();
+        void setDamp( float val );
+        float getFeedback();
+        void setFeedback( float val );
+
+    private:
+        std::array<float,  LANES> _feedback;
+        std::array<float,  LANES> _filterStore;
+        std::array<float,  LANES> _damp1;
+        std::array<float,  LANES> _damp2;
+        std::array<float*, LANES> _buffers;
+        std::array<int,    LANES> _bufSizes;
+        std::array<int,    LANES> _bufIndices;
+
+        // frame-major scratch memory (all lanes of a sample are adjacent)
+
+        static const int MAX_BLOCK_SIZE = 32;
+        std::array<float, MAX_BLOCK_SIZE * LANES> _scratch;
+};
+}
+
+#include "combbank.tcc"
+
+#endif
@@ -0,0 +1,177 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Based on freeverb by Jezar at Dreampoint (June 2000)
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+ #include <algorithm>
+
+ namespace Igorski {
+
+ template <int Channels, int Combs>
+ const int CombBank<Channels, Combs>::MAX_BLOCK_SIZE;
+
+ template <int Channels, int Combs>
+ CombBank<Channels, Combs>::CombBank()
+ {
+     _filterStore.fill( 0.f );
+     _bufIndices.fill( 0 );
+     _buffers.fill( nullptr );
+     _bufSizes.fill( 0 );
+
+     setFeedback( 0.f );
+     setDamp( 0.f );
+ }
+
+ template <int Channels, int Combs>
+ void CombBank<Channels, Combs>::setBuffer( int channel, int comb, float *buf, int size )
+ {
+     int lane = channel * Combs + comb;
+
+     _buffers [ lane ] = buf;
+     _bufSizes[ lane ] = size;
+ }
+
+ template <int Channels, int Combs>
+ void CombBank<Channels, Combs>::processBlock( float** in, float** out, int n )
+ {
+     // the filter state of all lanes is kept in registers for the duration of the block
+
+     static const int VECTORS = LANES / SIMD::WIDTH;
+     static const int TAIL    = VECTORS * SIMD::WIDTH;
+
+     SIMD::vfloat filterStore[ VECTORS + 1 ], damp1[ VECTORS + 1 ], damp2[ VECTORS + 1 ], feedback[ VECTORS + 1 ];
+
+     for ( int v = 0; v < VECTORS; ++v ) {
+         filterStore[ v ] = SIMD::load( &_filterStore[ v * SIMD::WIDTH ] );
+         damp1      [ v ] = SIMD::load( &_damp1      [ v * SIMD::WIDTH ] );
+         damp2      [ v ] = SIMD::load( &_damp2      [ v * SIMD::WIDTH ] );
+         feedback   [ v ] = SIMD::load( &_feedback   [ v * SIMD::WIDTH ] );
+     }
+
+     float sums[ Channels ][ MAX_BLOCK_SIZE ];
+     float* scratch = _scratch.data();
+
+     for ( int offset = 0; offset < n; )
+     {
+         // none of the delay lines may wrap around within a part
+
+         int length = std::min( n - offset, MAX_BLOCK_SIZE );
+         for ( int l = 0; l < LANES; ++l ) {
+             length = std::min( length, _bufSizes[ l ] - _bufIndices[ l ] );
+         }
+
+         // read the delayed signal of each comb into the scratch memory
+         // and sum it into the output of its channel
+
+         for ( int c = 0; c < Channels; ++c ) {
+             float* sum = sums[ c ];
+             for ( int i = 0; i < length; ++i ) {
+                 sum[ i ] = 0.f;
+             }
+             for ( int l = c * Combs; l < ( c + 1 ) * Combs; ++l ) {
+                 const float* read = _buffers[ l ] + _bufIndices[ l ];
+                 for ( int i = 0; i < length; ++i ) {
+                     scratch[ i * LANES + l ] = read[ i ];
+                     sum[ i ] += read[ i ];
+                 }
+             }
+         }
+
+         // damping recursion, each frame of the scratch is replaced by its feedback value
+
+         for ( int i = 0; i < length; ++i ) {
+             float* frame = scratch + i * LANES;
+
+             for ( int v = 0; v < VECTORS; ++v ) {
+                 filterStore[ v ] = SIMD::madd(
+                     SIMD::load( frame + v * SIMD::WIDTH ), damp2[ v ], SIMD::mul( filterStore[ v ], damp1[ v ] )
+                 );
+                 SIMD::store( frame + v * SIMD::WIDTH, SIMD::mul( filterStore[ v ], feedback[ v ] ));
+             }
+             for ( int l = TAIL; l < LANES; ++l ) {
+                 _filterStore[ l ] = ( frame[ l ] * _damp2[ l ] ) + ( _filterStore[ l ] * _damp1[ l ] );
+                 frame[ l ] = _filterStore[ l ] * _feedback[ l ];
+             }
+         }
+
+         for ( int l = 0; l < LANES; ++l ) {
+             const float* input = in[ l / Combs ] + offset;
+             float* write       = _buffers[ l ] + _bufIndices[ l ];
+
+             for ( int i = 0; i < length; ++i ) {
+                 write[ i ] = input[ i ] + scratch[ i * LANES + l ];
+             }
+             if (( _bufIndices[ l ] += length ) >= _bufSizes[ l ] ) {
+                 _bufIndices[ l ] = 0;
+             }
+         }
+
+         // in was fully consumed, it is now safe to write the (possibly aliased) output
+
+         for ( int c = 0; c < Channels; ++c ) {
+             float* output = out[ c ] + offset;
+             for ( int i = 0; i < length; ++i ) {
+                 output[ i ] = sums[ c ][ i ];
+             }
+         }
+         offset += length;
+     }
+
+     for ( int v = 0; v < VECTORS; ++v ) {
+         SIMD::store( &_filterStore[ v * SIMD::WIDTH ], filterStore[ v ] );
+     }
+ }
+
+ template <int Channels, int Combs>
+ void CombBank<Channels, Combs>::mute()
+ {
+     for ( int l = 0; l < LANES; ++l ) {
+         for ( int i = 0; i < _bufSizes[ l ]; ++i ) {
+             _buffers[ l ][ i ] = 0;
+         }
+     }
+ }
+
+ template <int Channels, int Combs>
+ float CombBank<Channels, Combs>::getDamp()
+ {
+     return _damp1[ 0 ];
+ }
+
+ template <int Channels, int Combs>
+ void CombBank<Channels, Combs>::setDamp( float val )
+ {
+     _damp1.fill( val );
+     _damp2.fill( 1 - val );
+ }
+
+ template <int Channels, int Combs>
+ float CombBank<Channels, Combs>::getFeedback()
+ {
+     return _feedback[ 0 ];
+ }
+
+ template <int Channels, int Combs>
+ void CombBank<Channels, Combs>::setFeedback( float val )
+ {
+     _feedback.fill( val );
+ }
+
+ }
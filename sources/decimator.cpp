@@ -22,10 +22,14 @@
  */
 #include "decimator.h"
 #include "calc.h"
+#include "simd.h"
+#include <algorithm>
 #include <math.h>
 
 namespace Igorski {
 
+const int Decimator::CHUNK_SIZE;
+
 /* constructor / destructor */
 
 Decimator::Decimator( int bits, float rate )
@@ -65,37 +69,81 @@ void Decimator::setRate( float value )
     _rate = Calc::cap( value );
 }
 
-void Decimator::store()
-{
-    _accumulatorStored = _accumulator;
-}
+/* public methods */
 
-void Decimator::restore()
+void Decimator::process( float** sampleBuffers, int numChannels, int bufferSize )
 {
-    _accumulator = _accumulatorStored;
-}
+    bool doProcess = isActive();
 
-/* public methods */
+    // the frames at which the oscillator reaches its peak are determined for a chunk of the
+    // block first, after which these frames are quantized in all channels. When the peaks are
+    // sparse only these frames are visited, otherwise whole vectors are blended using a mask
 
-void Decimator::process( float* sampleBuffer, int bufferSize )
-{
-    float sample;
-    bool doProcess = ( _bits < 32 );
+    const float m = ( float ) _m;
+
+    const SIMD::vfloat vM    = SIMD::set1( m );
+    const SIMD::vfloat vInvM = SIMD::set1( 1.f / m ); // exact as m is a power of two
+    const SIMD::vfloat vHalf = SIMD::set1( .5f );
 
-    for ( int i = 0; i < bufferSize; ++i )
+    int triggers[ CHUNK_SIZE ]; // all bits set for the frames at a peak
+    int indices [ CHUNK_SIZE ];
+
+    for ( int offset = 0; offset < bufferSize; offset += CHUNK_SIZE )
     {
-        sample = sampleBuffer[ i ];
-        _accumulator += _rate;
+        int length = std::min( CHUNK_SIZE, bufferSize - offset );
+        int amountOfTriggers = 0;
 
-        if ( _accumulator >= 1.f )
+        for ( int i = 0; i < length; ++i )
         {
-            _accumulator -= 1.f;
+            _accumulator += _rate;
+            triggers[ i ] = 0;
+
+            if ( _accumulator >= 1.f )
+            {
+                _accumulator -= 1.f;
+                triggers[ i ] = -1;
+                indices[ amountOfTriggers++ ] = i;
+            }
+        }
 
-            if ( doProcess )
-                sample = ( float ) _m * floor( sample / ( float ) _m + 0.5f );
+        if ( !doProcess || amountOfTriggers == 0 )
+            continue;
+
+        for ( int c = 0; c < numChannels; ++c )
+        {
+            float* buffer = sampleBuffers[ c ] + offset;
+
+            if ( amountOfTriggers * SIMD::WIDTH < length ) {
+                for ( int t = 0; t < amountOfTriggers; ++t ) {
+                    float* sample = buffer + indices[ t ];
+                    *sample = m * floor( *sample / m + 0.5f );
+                }
+                continue;
+            }
+
+            int i = 0;
+
+            for ( ; i + SIMD::WIDTH <= length; i += SIMD::WIDTH )
+            {
+                SIMD::vfloat sample    = SIMD::load( buffer + i );
+                SIMD::vfloat quantized = SIMD::mul( vM, SIMD::floor( SIMD::madd( sample, vInvM, vHalf )));
+
+                SIMD::store( buffer + i, SIMD::blend( SIMD::loadInt( triggers + i ), sample, quantized ));
+            }
+
+            for ( ; i < length; ++i ) {
+                if ( triggers[ i ] != 0 ) {
+                    buffer[ i ] = m * floor( buffer[ i ] / m + 0.5f );
+                }
+            }
         }
-        sampleBuffer[ i ] = sample;
     }
 }
 
+bool Decimator::isActive()
+{
+    // at a rate of 0 the oscillator never reaches its peak
+    return _bits < 32 && _rate > 0.f;
+}
+
 }
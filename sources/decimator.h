@@ -43,21 +43,22 @@ class Decimator {
         float getRate();
         void setRate( float value );
 
-        void process( float* sampleBuffer, int bufferSize );
+        // all channels are processed frame by frame
+        // so they share the same oscillator position
 
-        // store/restore the processor properties
-        // this ensures that multi channel processing for a
-        // single buffer uses all properties across all channels
+        void process( float** sampleBuffers, int numChannels, int bufferSize );
 
-        void store();
-        void restore();
+        // whether process() alters the signal at the current settings
+
+        bool isActive();
 
     private:
+        static const int CHUNK_SIZE = 64; // frames for which the oscillator peaks are determined at once
+
         int _bits;
         long _m;
         float _rate;
         float _accumulator;
-        float _accumulatorStored;
 };
 }
 
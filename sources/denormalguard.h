@@ -0,0 +1,100 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __DENORMALGUARD_H_INCLUDED__
+#define __DENORMALGUARD_H_INCLUDED__
+
+#if defined(__SSE__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 1 )
+#   include <xmmintrin.h>
+#   define FOGPAD_DENORMALS_MXCSR 1
+#elif defined(__aarch64__) || ( defined(__arm__) && defined(__ARM_FP) )
+#   define FOGPAD_DENORMALS_FPCR 1
+#endif
+
+namespace Igorski {
+/**
+ * DenormalGuard makes the floating point unit flush denormal numbers to zero
+ * for as long as it is in scope, the previous mode is restored upon destruction
+ *
+ * the feedback loops of the reverb decay towards zero, without flushing the
+ * tail ends up in the denormal range where each operation is many times slower
+ * the mode is per thread, as such the guard should be created at the top of the
+ * audio callback (and not shared between threads)
+ */
+class DenormalGuard
+{
+    public:
+        DenormalGuard()
+        {
+#if defined(FOGPAD_DENORMALS_MXCSR)
+            // flush to zero (bit 15) and denormals are zero (bit 6)
+            _state = _mm_getcsr();
+            _mm_setcsr( _state | 0x8040 );
+#elif defined(FOGPAD_DENORMALS_FPCR)
+            // flush to zero (bit 24), which on ARM applies to both inputs and results
+            _state = getFPCR();
+            setFPCR( _state | ( 1 << 24 ));
+#endif
+        }
+
+        ~DenormalGuard()
+        {
+#if defined(FOGPAD_DENORMALS_MXCSR)
+            _mm_setcsr( _state );
+#elif defined(FOGPAD_DENORMALS_FPCR)
+            setFPCR( _state );
+#endif
+        }
+
+    private:
+        DenormalGuard( const DenormalGuard& );
+        DenormalGuard& operator=( const DenormalGuard& );
+
+#if defined(FOGPAD_DENORMALS_MXCSR)
+        unsigned int _state;
+#elif defined(FOGPAD_DENORMALS_FPCR)
+        unsigned long _state;
+
+        static inline unsigned long getFPCR()
+        {
+            unsigned long value;
+#if defined(__aarch64__)
+            __asm__ __volatile__( "mrs %0, fpcr" : "=r"( value ));
+#else
+            __asm__ __volatile__( "vmrs %0, fpscr" : "=r"( value ));
+#endif
+            return value;
+        }
+
+        static inline void setFPCR( unsigned long value )
+        {
+#if defined(__aarch64__)
+            __asm__ __volatile__( "msr fpcr, %0" : : "r"( value ));
+#else
+            __asm__ __volatile__( "vmsr fpscr, %0" : : "r"( value ));
+#endif
+        }
+#endif
+};
+}
+
+#endif
@@ -22,11 +22,17 @@
  */
 #include "filter.h"
 #include "global.h"
+#include "arena.h"
+#include "simd.h"
 #include <algorithm>
+#include <string.h>
 
 namespace Igorski {
 
-Filter::Filter( float sampleRate ) {
+const int Filter::BLOCK_SIZE;
+const int Filter::STATE_SIZE;
+
+Filter::Filter( float sampleRate ) : lfo( sampleRate ) {
     _sampleRate = sampleRate;
 
     _cutoff     = VST::FILTER_MIN_FREQ;
@@ -44,34 +50,30 @@ Filter::Filter( float sampleRate ) {
     _b2 = 0.f;
     _c  = 0.f;
 
-    lfo = new Igorski::LFO( sampleRate );
+    _controlRate = DEFAULT_CONTROL_RATE;
+    _rampSamples = 0;
+    _da1 = _da2 = _da3 = _db1 = _db2 = 0.f;
+
+    _topology = DEFAULT_TOPOLOGY;
+    _g   = 0.f;
+    _k   = 0.f;
+    _dg  = 0.f;
+    _ga1 = _ga2 = _ga3 = 0.f;
 
     _hasLFO = false;
 
-    // stereo (2) probably enough...
-    int numChannels = 8;
+    // the state memory is provided by setMemory()
 
-    _in1  = new float[ numChannels ];
-    _in2  = new float[ numChannels ];
-    _out1 = new float[ numChannels ];
-    _out2 = new float[ numChannels ];
+    _amountOfChannels = 0;
+    _lanes  = 0;
+    _state  = nullptr;
+    _frames = nullptr;
 
-    for ( int i = 0; i < numChannels; ++i )
-    {
-        _in1 [ i ] = 0.f;
-        _in2 [ i ] = 0.f;
-        _out1[ i ] = 0.f;
-        _out2[ i ] = 0.f;
-    }
     setCutoff( VST::FILTER_MAX_FREQ / 2 );
 }
 
 Filter::~Filter() {
-    delete lfo;
-    delete[] _in1;
-    delete[] _in2;
-    delete[] _out1;
-    delete[] _out2;
+    // nowt...
 }
 
 /* public methods */
@@ -95,7 +97,7 @@ void Filter::updateProperties( float cutoffPercentage, float resonancePercentage
     else if ( doLFO ) {
         setLFO( true );
         cacheLFOProperties();
-        lfo->setRate(
+        lfo.setRate(
             VST::MIN_LFO_RATE() + (
                 LFORatePercentage * ( VST::MAX_LFO_RATE() - VST::MIN_LFO_RATE() )
             )
@@ -103,32 +105,52 @@ void Filter::updateProperties( float cutoffPercentage, float resonancePercentage
     }
 }
 
-void Filter::process( float* sampleBuffer, int bufferSize, int c )
+size_t Filter::getMemorySize( int amountOfChannels )
 {
-    for ( int32 i = 0; i < bufferSize; ++i )
-    {
-        float input  = sampleBuffer[ i ];
-        float output = _a1 * input + _a2 * _in1[ c ] + _a3 * _in2[ c ] - _b1 * _out1[ c ] - _b2 * _out2[ c ];
+    size_t lanes = ( amountOfChannels + SIMD::WIDTH - 1 ) / SIMD::WIDTH * SIMD::WIDTH;
+    return Arena::align( lanes * STATE_SIZE * sizeof( float )) + Arena::align( lanes * BLOCK_SIZE * sizeof( float ));
+}
 
-        _in2 [ c ] = _in1[ c ];
-        _in1 [ c ] = input;
-        _out2[ c ] = _out1[ c ];
-        _out1[ c ] = output;
+void Filter::setMemory( float* memory, int amountOfChannels )
+{
+    _amountOfChannels = amountOfChannels;
+    _lanes  = ( amountOfChannels + SIMD::WIDTH - 1 ) / SIMD::WIDTH * SIMD::WIDTH;
+    _state  = memory;
+    _frames = memory + Arena::align( _lanes * STATE_SIZE * sizeof( float )) / sizeof( float );
 
-        // oscillator attached to Filter ? travel the cutoff values
-        // between the minimum and maximum frequencies
+    clearState();
+}
 
-        if ( _hasLFO )
-        {
-            // multiply by .5 and add .5 to make bipolar waveform unipolar
-            float lfoValue = lfo->peek() * .5f  + .5f;
-            _tempCutoff = std::min( _lfoMax, _lfoMin + _lfoRange * lfoValue );
+void Filter::process( AudioBufferView buffer, const float* modulation )
+{
+    int numChannels = std::min( buffer.amountOfChannels, _amountOfChannels );
 
-            calculateParameters();
+    for ( int offset = 0; offset < buffer.bufferSize; offset += BLOCK_SIZE )
+    {
+        int length = std::min( BLOCK_SIZE, buffer.bufferSize - offset );
+
+        // interleave the channels into frames so each channel occupies a lane
+
+        for ( int c = 0; c < numChannels; ++c ) {
+            const float* channel = buffer.getChannel( c ) + offset;
+            for ( int i = 0; i < length; ++i ) {
+                _frames[ i * _lanes + c ] = channel[ i ];
+            }
+        }
+
+        if ( _topology == SVF ) {
+            processSVF( length, modulation + offset, buffer.bufferSize - offset );
+        } else {
+            processBiquad( length, modulation + offset, buffer.bufferSize - offset );
         }
 
-        // commit the effect
-        sampleBuffer[ i ] = output;
+        for ( int c = 0; c < numChannels; ++c ) {
+            float* channel = buffer.getChannel( c ) + offset;
+            for ( int i = 0; i < length; ++i ) {
+                // commit the effect
+                channel[ i ] = _frames[ i * _lanes + c ];
+            }
+        }
     }
 }
 
@@ -143,6 +165,7 @@ void Filter::setCutoff( float frequency )
     _tempCutoff = _cutoff * tempRatio;
 
     calculateParameters();
+    _rampSamples = 0;
 }
 
 float Filter::getCutoff()
@@ -154,6 +177,7 @@ void Filter::setResonance( float resonance )
 {
     _resonance = std::max( VST::FILTER_MIN_RESONANCE, std::min( resonance, VST::FILTER_MAX_RESONANCE ));
     calculateParameters();
+    _rampSamples = 0;
 }
 
 float Filter::getResonance()
@@ -172,25 +196,58 @@ void Filter::setLFO( bool enabled )
         _tempCutoff = _cutoff;
         cacheLFOProperties();
         calculateParameters();
+        _rampSamples = 0;
     }
 }
 
-void Filter::store()
+bool Filter::hasLFO()
+{
+    return _hasLFO;
+}
+
+void Filter::setControlRate( int samples )
 {
-    _accumulatorStored = lfo->getAccumulator();
-    _tempCutoffStored  = _tempCutoff;
+    _controlRate = std::max( 1, samples );
+    _rampSamples = 0;
 }
 
-void Filter::restore()
+int Filter::getControlRate()
 {
-    lfo->setAccumulator( _accumulatorStored );
-    _tempCutoff = _tempCutoffStored;
+    return _controlRate;
+}
+
+void Filter::setTopology( Topology topology )
+{
+    if ( topology == _topology )
+        return;
+
+    _topology    = topology;
+    _rampSamples = 0;
+
     calculateParameters();
+    clearState();
+}
+
+Filter::Topology Filter::getTopology()
+{
+    return _topology;
 }
 
 void Filter::calculateParameters()
 {
-    _c  = 1.f / tan( VST::PI * _tempCutoff / _sampleRate );
+    _g = tan( VST::PI * _tempCutoff / _sampleRate );
+    _k = _resonance;
+
+    // only the coefficients of the active topology are calculated
+
+    if ( _topology == SVF ) {
+        _ga1 = 1.f / ( 1.f + _g * ( _g + _k ));
+        _ga2 = _g * _ga1;
+        _ga3 = _g * _ga2;
+        return;
+    }
+
+    _c  = 1.f / _g;
     _a1 = 1.f / ( 1.f + _resonance * _c + _c * _c );
     _a2 = 2.f * _a1;
     _a3 = _a1;
@@ -198,6 +255,252 @@ void Filter::calculateParameters()
     _b2 = ( 1.f - _resonance * _c + _c * _c ) * _a1;
 }
 
+/* private methods */
+
+void Filter::startRamp( float lfoValue, int samples )
+{
+    // calculate the coefficients for the cutoff at given LFO value, the current
+    // coefficients are moved towards these over given amount of samples
+
+    float a1 = _a1, a2 = _a2, a3 = _a3, b1 = _b1, b2 = _b2, g = _g;
+
+    // multiply by .5 and add .5 to make bipolar waveform unipolar
+    _tempCutoff = std::min( _lfoMax, _lfoMin + _lfoRange * ( lfoValue * .5f + .5f ));
+    calculateParameters();
+
+    float step = 1.f / ( float ) samples;
+
+    if ( _topology == SVF ) {
+        _dg = ( _g - g ) * step;
+        _g  = g;
+    }
+    else {
+        _da1 = ( _a1 - a1 ) * step;
+        _da2 = ( _a2 - a2 ) * step;
+        _da3 = ( _a3 - a3 ) * step;
+        _db1 = ( _b1 - b1 ) * step;
+        _db2 = ( _b2 - b2 ) * step;
+
+        _a1 = a1;
+        _a2 = a2;
+        _a3 = a3;
+        _b1 = b1;
+        _b2 = b2;
+    }
+    _rampSamples = samples;
+}
+
+void Filter::clearState()
+{
+    if ( _state != nullptr ) {
+        memset( _state, 0, _lanes * STATE_SIZE * sizeof( float ));
+    }
+}
+
+void Filter::processBiquad( int bufferSize, const float* modulation, int available )
+{
+    // determine the coefficients for each frame of the block (these are shared by all channels)
+
+    float coefficients[ 5 ][ BLOCK_SIZE ];
+
+    for ( int i = 0; i < bufferSize; ++i )
+    {
+        // oscillator attached to Filter ? travel the cutoff values
+        // between the minimum and maximum frequencies
+
+        if ( _hasLFO && _controlRate == 1 )
+        {
+            // multiply by .5 and add .5 to make bipolar waveform unipolar
+            float lfoValue = modulation[ i ] * .5f  + .5f;
+            _tempCutoff = std::min( _lfoMax, _lfoMin + _lfoRange * lfoValue );
+
+            calculateParameters();
+        }
+        else if ( _hasLFO ) {
+            // move the coefficients towards the next control point (reaching the value
+            // of the LFO at its frame), ramps end at the last frame of the buffer
+            if ( _rampSamples == 0 ) {
+                int length = std::min( _controlRate, available - i );
+                startRamp( modulation[ i + length - 1 ], length );
+            }
+            --_rampSamples;
+
+            _a1 += _da1;
+            _a2 += _da2;
+            _a3 += _da3;
+            _b1 += _db1;
+            _b2 += _db2;
+        }
+        coefficients[ 0 ][ i ] = _a1;
+        coefficients[ 1 ][ i ] = _a2;
+        coefficients[ 2 ][ i ] = _a3;
+        coefficients[ 3 ][ i ] = _b1;
+        coefficients[ 4 ][ i ] = _b2;
+    }
+
+    // run the filter over the lanes, two groups at a time so their recursions overlap
+
+    int l = 0;
+    for ( ; l + 2 * SIMD::WIDTH <= _lanes; l += 2 * SIMD::WIDTH ) {
+        runBiquad<2>( l, bufferSize, coefficients );
+    }
+    for ( ; l < _lanes; l += SIMD::WIDTH ) {
+        runBiquad<1>( l, bufferSize, coefficients );
+    }
+}
+
+void Filter::processSVF( int bufferSize, const float* modulation, int available )
+{
+    // when the LFO is active g moves linearly towards its value at the next control point
+    // (calculated by startRamp()) and the gains are derived from it for every frame, which
+    // keeps the filter stable under fast modulation. Otherwise the cached gains are used
+
+    float gains[ 3 ][ BLOCK_SIZE ];
+
+    if ( !_hasLFO ) {
+        for ( int i = 0; i < bufferSize; ++i ) {
+            gains[ 0 ][ i ] = _ga1;
+            gains[ 1 ][ i ] = _ga2;
+            gains[ 2 ][ i ] = _ga3;
+        }
+    }
+    else {
+        // ramp g in spans between control points, keeping it in a register
+
+        for ( int i = 0; i < bufferSize; )
+        {
+            if ( _rampSamples == 0 ) {
+                int length = std::min( _controlRate, available - i );
+                startRamp( modulation[ i + length - 1 ], length );
+            }
+            int span = std::min( _rampSamples, bufferSize - i );
+
+            float g  = _g;
+            float dg = _dg;
+            float k  = _k;
+
+            for ( int end = i + span; i < end; ++i ) {
+                g += dg;
+
+                float ga1 = 1.f / ( 1.f + g * ( g + k ));
+
+                gains[ 0 ][ i ] = ga1;
+                gains[ 1 ][ i ] = g * ga1;
+                gains[ 2 ][ i ] = g * g * ga1;
+            }
+            _g = g;
+            _rampSamples -= span;
+        }
+    }
+
+    int l = 0;
+    for ( ; l + 2 * SIMD::WIDTH <= _lanes; l += 2 * SIMD::WIDTH ) {
+        runSVF<2>( l, bufferSize, gains );
+    }
+    for ( ; l < _lanes; l += SIMD::WIDTH ) {
+        runSVF<1>( l, bufferSize, gains );
+    }
+}
+
+template <int Groups>
+void Filter::runBiquad( int lane, int bufferSize, const float coefficients[][ BLOCK_SIZE ] )
+{
+    // the state of the lane groups is kept in registers for the duration of the block
+
+    float* in1  = _state + lane;
+    float* in2  = in1  + _lanes;
+    float* out1 = in2  + _lanes;
+    float* out2 = out1 + _lanes;
+
+    SIMD::vfloat x1[ Groups ], x2[ Groups ], y1[ Groups ], y2[ Groups ];
+
+    for ( int g = 0; g < Groups; ++g ) {
+        x1[ g ] = SIMD::load( in1  + g * SIMD::WIDTH );
+        x2[ g ] = SIMD::load( in2  + g * SIMD::WIDTH );
+        y1[ g ] = SIMD::load( out1 + g * SIMD::WIDTH );
+        y2[ g ] = SIMD::load( out2 + g * SIMD::WIDTH );
+    }
+
+    for ( int i = 0; i < bufferSize; ++i )
+    {
+        SIMD::vfloat a1 = SIMD::set1( coefficients[ 0 ][ i ] );
+        SIMD::vfloat a2 = SIMD::set1( coefficients[ 1 ][ i ] );
+        SIMD::vfloat a3 = SIMD::set1( coefficients[ 2 ][ i ] );
+        SIMD::vfloat b1 = SIMD::set1( coefficients[ 3 ][ i ] );
+        SIMD::vfloat b2 = SIMD::set1( coefficients[ 4 ][ i ] );
+
+        float* frame = _frames + i * _lanes + lane;
+
+        for ( int g = 0; g < Groups; ++g )
+        {
+            SIMD::vfloat x = SIMD::load( frame + g * SIMD::WIDTH );
+
+            // the feedback of the previous output is applied last as it is the only term
+            // depending on the output of the previous frame
+
+            SIMD::vfloat y = SIMD::madd( a3, x2[ g ], SIMD::madd( a2, x1[ g ], SIMD::mul( a1, x )));
+            y = SIMD::sub( SIMD::sub( y, SIMD::mul( b2, y2[ g ] )), SIMD::mul( b1, y1[ g ] ));
+
+            x2[ g ] = x1[ g ];
+            x1[ g ] = x;
+            y2[ g ] = y1[ g ];
+            y1[ g ] = y;
+
+            SIMD::store( frame + g * SIMD::WIDTH, y );
+        }
+    }
+
+    for ( int g = 0; g < Groups; ++g ) {
+        SIMD::store( in1  + g * SIMD::WIDTH, x1[ g ] );
+        SIMD::store( in2  + g * SIMD::WIDTH, x2[ g ] );
+        SIMD::store( out1 + g * SIMD::WIDTH, y1[ g ] );
+        SIMD::store( out2 + g * SIMD::WIDTH, y2[ g ] );
+    }
+}
+
+template <int Groups>
+void Filter::runSVF( int lane, int bufferSize, const float gains[][ BLOCK_SIZE ] )
+{
+    float* ic1eq = _state + _lanes * 4 + lane;
+    float* ic2eq = ic1eq + _lanes;
+
+    SIMD::vfloat s1[ Groups ], s2[ Groups ];
+
+    for ( int g = 0; g < Groups; ++g ) {
+        s1[ g ] = SIMD::load( ic1eq + g * SIMD::WIDTH );
+        s2[ g ] = SIMD::load( ic2eq + g * SIMD::WIDTH );
+    }
+
+    const SIMD::vfloat two = SIMD::set1( 2.f );
+
+    for ( int i = 0; i < bufferSize; ++i )
+    {
+        SIMD::vfloat a1 = SIMD::set1( gains[ 0 ][ i ] );
+        SIMD::vfloat a2 = SIMD::set1( gains[ 1 ][ i ] );
+        SIMD::vfloat a3 = SIMD::set1( gains[ 2 ][ i ] );
+
+        float* frame = _frames + i * _lanes + lane;
+
+        for ( int g = 0; g < Groups; ++g )
+        {
+            SIMD::vfloat v3 = SIMD::sub( SIMD::load( frame + g * SIMD::WIDTH ), s2[ g ] );
+            SIMD::vfloat v1 = SIMD::madd( a1, s1[ g ], SIMD::mul( a2, v3 ));
+            SIMD::vfloat v2 = SIMD::add( s2[ g ], SIMD::madd( a2, s1[ g ], SIMD::mul( a3, v3 )));
+
+            s1[ g ] = SIMD::sub( SIMD::mul( two, v1 ), s1[ g ] );
+            s2[ g ] = SIMD::sub( SIMD::mul( two, v2 ), s2[ g ] );
+
+            // low pass output
+            SIMD::store( frame + g * SIMD::WIDTH, v2 );
+        }
+    }
+
+    for ( int g = 0; g < Groups; ++g ) {
+        SIMD::store( ic1eq + g * SIMD::WIDTH, s1[ g ] );
+        SIMD::store( ic2eq + g * SIMD::WIDTH, s2[ g ] );
+    }
+}
+
 void Filter::cacheLFOProperties()
 {
     _lfoRange = _cutoff * _depth;
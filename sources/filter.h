@@ -25,12 +25,30 @@
 
 #include "global.h"
 #include "lfo.h"
+#include "audiobuffer.h"
 #include <math.h>
 
 namespace Igorski {
 class Filter {
 
     public:
+        // the filter is either a direct form biquad or a topology-preserving (trapezoidal)
+        // state variable filter. The latter remains stable under fast cutoff modulation and
+        // its coefficients are cheaper to update. Both are 12 dB/oct low pass filters
+
+        enum Topology {
+            BIQUAD,
+            SVF
+        };
+
+        // the default topology can be selected at build time by defining FOGPAD_FILTER_SVF
+
+#ifdef FOGPAD_FILTER_SVF
+        static const Topology DEFAULT_TOPOLOGY = SVF;
+#else
+        static const Topology DEFAULT_TOPOLOGY = BIQUAD;
+#endif
+
         Filter( float sampleRate );
         ~Filter();
 
@@ -41,23 +59,41 @@ class Filter {
         void setDepth( float depth );
         float getDepth();
         void setLFO( bool enabled );
+        bool hasLFO();
+
+        // while the LFO is active the coefficients are calculated once every given amount of
+        // samples (for the value of the LFO at the end of the period) and interpolated linearly
+        // in between, 1 calculates these for every sample. See utils/sources/filtercheck.cpp
+
+        static const int DEFAULT_CONTROL_RATE = 16; // 0.36 ms at 44.1 kHz
+
+        void setControlRate( int samples );
+        int getControlRate();
+
+        // switching the topology clears the filter state
+
+        void setTopology( Topology topology );
+        Topology getTopology();
 
         void calculateParameters();
 
         // update Filter properties, the values here are in normalized 0 - 1 range
         void updateProperties( float cutoffPercentage, float resonancePercentage, float LFORatePercentage, float fLFODepth );
 
-        // apply filter to incoming sampleBuffer contents
-        void process( float* sampleBuffer, int bufferSize, int c );
+        // the filter state (and scratch memory) for given amount of channels is provided by the
+        // owner of the filter (e.g. from its arena) and must be set before processing. Setting
+        // the memory clears the filter state, getMemorySize() returns the required amount of bytes
+
+        static size_t getMemorySize( int amountOfChannels );
+        void setMemory( float* memory, int amountOfChannels );
 
-        LFO* lfo;
+        // apply filter onto the channels of given buffer, all channels are processed frame by
+        // frame (side by side in vector lanes) so they share the same LFO modulation. The values
+        // of the LFO for the block are provided by the caller (see ModulationBus)
 
-        // store/restore the processor properties
-        // this ensures that multi channel processing for a
-        // single buffer uses all properties across all channels
+        void process( AudioBufferView buffer, const float* modulation );
 
-        void store();
-        void restore();
+        LFO lfo; // configured by the filter, rendered by the ModulationBus
 
     private:
         float _cutoff;
@@ -71,9 +107,6 @@ class Filter {
 
         // used internally
 
-        float _accumulatorStored;
-        float _tempCutoffStored;
-
         float _a1;
         float _a2;
         float _a3;
@@ -81,14 +114,51 @@ class Filter {
         float _b2;
         float _c;
 
-        float* _in1;
-        float* _in2;
-        float* _out1;
-        float* _out2;
+        // coefficient increments while interpolating towards the next control point
+
+        int   _controlRate;
+        int   _rampSamples; // samples left until the next control point
+        float _da1, _da2, _da3, _db1, _db2;
+
+        // state variable filter, g is the prewarped cutoff and k the damping (1 / Q). The gains
+        // derived from these are cached while unmodulated, while modulated g is interpolated
+        // (the gains are derived from g for every sample, keeping the filter stable)
+
+        Topology _topology;
+        float _g;
+        float _k;
+        float _dg;
+        float _ga1, _ga2, _ga3;
+
+        // the channels are processed in blocks, interleaved into vector lanes (the amount
+        // of channels rounded up to the vector width). The state holds a value per lane
+        // for each of in1, in2, out1, out2 (biquad) and ic1eq, ic2eq (state variable filter)
+
+        static const int BLOCK_SIZE = 32;
+        static const int STATE_SIZE = 6;
+
+        int    _amountOfChannels;
+        int    _lanes;
+        float* _state;
+        float* _frames; // BLOCK_SIZE interleaved frames
 
         float _sampleRate;
 
         void cacheLFOProperties();
+        void startRamp( float lfoValue, int samples );
+        void clearState();
+        // available is the amount of modulation values from given pointer (the remainder of the
+        // buffer), the ramps look ahead to the value at their end and do not cross the buffer end
+
+        void processBiquad( int bufferSize, const float* modulation, int available );
+        void processSVF( int bufferSize, const float* modulation, int available );
+
+        // runs the filter over given amount of adjacent lane groups starting at given lane
+
+        template <int Groups>
+        void runBiquad( int lane, int bufferSize, const float coefficients[][ BLOCK_SIZE ] );
+        template <int Groups>
+        void runSVF( int lane, int bufferSize, const float gains[][ BLOCK_SIZE ] );
 };
 }
 
@@ -25,9 +25,9 @@
 namespace Igorski {
 
 LFO::LFO( float sampleRate ) {
-    _sampleRate  = sampleRate;
-    _rate        = VST::MIN_LFO_RATE();
-    _accumulator = 0.f;
+    _sampleRate = sampleRate;
+    _phase      = 0;
+    setRate( VST::MIN_LFO_RATE() );
 }
 
 LFO::~LFO() {
@@ -44,16 +44,20 @@ float LFO::getRate()
 void LFO::setRate( float value )
 {
     _rate = value;
-}
 
-void LFO::setAccumulator( float value )
-{
-    _accumulator = value;
+    // a full cycle spans the 32-bit range of the phase
+    _phaseIncrement = ( uint32_t ) (( double ) value / _sampleRate * 4294967296.0 );
 }
 
-float LFO::getAccumulator()
+void LFO::fill( float* buffer, int amount )
 {
-    return _accumulator;
+    uint32_t phase = _phase;
+
+    for ( int i = 0; i < amount; ++i ) {
+        buffer[ i ] = read( phase );
+        phase += _phaseIncrement;
+    }
+    _phase = phase;
 }
 
 }
@@ -24,6 +24,7 @@
 #define __LFO_H_INCLUDED__
 
 #include "global.h"
+#include <stdint.h>
 
 namespace Igorski {
 class LFO {
@@ -35,47 +36,40 @@ class LFO {
         float getRate();
         void setRate( float value );
 
-        // accumulators are used to retrieve a sample from the wave table
-        // in other words: track the progress of the oscillator against its range
-
-        float getAccumulator();
-        void setAccumulator( float offset );
-
         /**
-         * retrieve a value from the wave table for the current
-         * accumulator position, this method also increments
-         * the accumulator and keeps it within bounds
+         * write the values for the next amount of samples into given buffer
+         * (interpolated between the neighbouring wave table entries), this
+         * advances the phase, which wraps around at the end of the cycle by itself
          */
-        inline float peek()
-        {
-            float sampleRate = _sampleRate;
-
-            // the wave table offset to read from
-            float SR_OVER_LENGTH = sampleRate / ( float ) TABLE_SIZE;
-            int readOffset = ( _accumulator == 0.f ) ? 0 : ( int ) ( _accumulator / SR_OVER_LENGTH );
+        void fill( float* buffer, int amount );
 
-            // increment the accumulators read offset
-            _accumulator += _rate;
-
-            // keep the accumulator within the bounds of the sample frequency
-            if ( _accumulator > sampleRate )
-                _accumulator -= sampleRate;
+    private:
 
-            // return the sample present at the calculated offset within the table
-            return VST::TABLE[ readOffset ];
-        }
+        // see Igorski::VST::TABLE, the phase is a 32-bit fixed point value spanning a
+        // single cycle: the upper bits index the table, the lower bits hold the fraction
 
-    private:
+        static const int TABLE_SIZE    = 128;
+        static const int TABLE_BITS    = 7;
+        static const int FRACTION_BITS = 32 - TABLE_BITS;
 
-        // see Igorski::VST::LFO_TABLE;
-        static const int TABLE_SIZE = 128;
+        static const uint32_t FRACTION_MASK = ( 1u << FRACTION_BITS ) - 1;
 
         // used internally
 
         float _rate;
-        float _accumulator;   // is read offset in wave table buffer
-
         float _sampleRate;
+
+        uint32_t _phase;
+        uint32_t _phaseIncrement;
+
+        inline static float read( uint32_t phase )
+        {
+            int index      = phase >> FRACTION_BITS;
+            float fraction = ( float ) ( phase & FRACTION_MASK ) * ( 1.f / ( float ) ( 1u << FRACTION_BITS ));
+            float current  = VST::TABLE[ index ];
+
+            return current + ( VST::TABLE[ ( index + 1 ) & ( TABLE_SIZE - 1 ) ] - current ) * fraction;
+        }
 };
 }
 
@@ -0,0 +1,82 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "modulationbus.h"
+#include "arena.h"
+#include <algorithm>
+
+namespace Igorski {
+
+ModulationBus::ModulationBus()
+{
+    for ( int i = 0; i < AMOUNT_OF_SOURCES; ++i ) {
+        _sources[ i ] = nullptr;
+        _active [ i ] = false;
+        _buffers[ i ] = nullptr;
+    }
+    _maxBufferSize = 0;
+}
+
+ModulationBus::~ModulationBus()
+{
+    // nowt...
+}
+
+/* public methods */
+
+void ModulationBus::setSource( Source source, LFO* lfo )
+{
+    _sources[ source ] = lfo;
+}
+
+void ModulationBus::setActive( Source source, bool active )
+{
+    _active[ source ] = active;
+}
+
+size_t ModulationBus::getMemorySize( int maxBufferSize )
+{
+    return Arena::align( maxBufferSize * sizeof( float )) * AMOUNT_OF_SOURCES;
+}
+
+void ModulationBus::setMemory( float* memory, int maxBufferSize )
+{
+    size_t stride = Arena::align( maxBufferSize * sizeof( float )) / sizeof( float );
+
+    for ( int i = 0; i < AMOUNT_OF_SOURCES; ++i ) {
+        _buffers[ i ] = memory + i * stride;
+    }
+    _maxBufferSize = maxBufferSize;
+}
+
+void ModulationBus::render( int bufferSize )
+{
+    bufferSize = std::min( bufferSize, _maxBufferSize );
+
+    for ( int i = 0; i < AMOUNT_OF_SOURCES; ++i ) {
+        if ( _active[ i ] && _sources[ i ] != nullptr && _buffers[ i ] != nullptr ) {
+            _sources[ i ]->fill( _buffers[ i ], bufferSize );
+        }
+    }
+}
+
+}
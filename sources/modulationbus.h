@@ -0,0 +1,81 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __MODULATIONBUS_H_INCLUDED__
+#define __MODULATIONBUS_H_INCLUDED__
+
+#include "lfo.h"
+#include <stddef.h>
+
+namespace Igorski {
+/**
+ * The ModulationBus renders the modulation sources of a reverb instance into
+ * block sized buffers once at the start of each block. The modulated effects
+ * read their values from these buffers, so all channels share the same
+ * modulation and the sources are not evaluated inside the sample loops.
+ *
+ * The oscillators remain owned (and configured) by the effects they modulate.
+ */
+class ModulationBus
+{
+    public:
+        enum Source {
+            FILTER_LFO,
+            BIT_CRUSHER_LFO,
+            AMOUNT_OF_SOURCES
+        };
+
+        ModulationBus();
+        ~ModulationBus();
+
+        void setSource( Source source, LFO* lfo );
+
+        // only the sources of active destinations are rendered (and advance their phase)
+
+        void setActive( Source source, bool active );
+
+        // the buffers hold given amount of samples, their memory is provided by the
+        // owner of the bus (e.g. from its arena), getMemorySize() returns the required bytes
+
+        static size_t getMemorySize( int maxBufferSize );
+        void setMemory( float* memory, int maxBufferSize );
+
+        // render all active sources for the next block of given size (up to the max buffer size)
+
+        void render( int bufferSize );
+
+        // the (bipolar) values of given source for the current block
+
+        inline const float* getBuffer( Source source )
+        {
+            return _buffers[ source ];
+        }
+
+    private:
+        LFO*   _sources[ AMOUNT_OF_SOURCES ];
+        bool   _active [ AMOUNT_OF_SOURCES ];
+        float* _buffers[ AMOUNT_OF_SOURCES ];
+        int    _maxBufferSize;
+};
+}
+
+#endif
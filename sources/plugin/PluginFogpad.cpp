@@ -25,7 +25,11 @@
 #include "SharedFogpad.hpp"
 #include "paramids.h"
 #include "calc.h"
+#include "denormalguard.h"
+#include "allocationguard.h"
+#include <assert.h>
 #include <math.h>
+#include <stdlib.h>
 
 namespace Igorski {
 
@@ -48,9 +52,21 @@ PluginFogpad::PluginFogpad()
     , fFilterResonance( 1.f )
     , fLFOFilter( 0.f )
     , fLFOFilterDepth( 0.5f )
+    , fParametersChanged( false )
     , outputGain( 0.f )
     , reverbProcess( nullptr )
+    , fWorkerRunning( false )
+    , fWorkRequested( false )
+    , fRequestedSampleRate( 0.0 )
+    , fActiveProcess( nullptr )
+    , fPendingProcess( nullptr )
+    , fRetiredProcess( nullptr )
 {
+#ifdef DEBUG
+    // an allocation made while an AllocationGuard is active must trigger an assertion
+    assert(AllocationGuard::isTrapping() && "operator new is not replaced, see allocationguard.cpp");
+#endif
+
     fParameterRanges = new ParameterRangesSimple[kNumParameters];
 
     for (unsigned i = 0; i < kNumParameters; ++i) {
@@ -59,7 +75,9 @@ PluginFogpad::PluginFogpad()
         fParameterRanges[i] = ParameterRangesSimple{param.ranges.def, param.ranges.min, param.ranges.max};
     }
 
-    sampleRateChanged(getSampleRate());
+    // the initial process is created synchronously (no audio is processed yet)
+    reverbProcess = createProcess(getSampleRate());
+    fActiveProcess.store(reverbProcess);
 
     for (unsigned i = 0; i < kNumParameters; ++i) {
         ParameterRangesSimple range = fParameterRanges[i];
@@ -70,6 +88,10 @@ PluginFogpad::PluginFogpad()
 PluginFogpad::~PluginFogpad()
 {
     // free all allocated resources
+    stopWorker();
+
+    collectRetiredProcess();
+    delete fPendingProcess.exchange(nullptr);
     delete reverbProcess;
     delete[] fParameterRanges;
 }
@@ -86,11 +108,13 @@ void PluginFogpad::initParameter(uint32_t index, Parameter& parameter) {
 
 /**
   Optional callback to inform the plugin about a sample rate change.
+  Creating the process allocates its delay lines, this is done by
+  activate() or (should the plugin be active) by the worker thread
+  after which the audio thread swaps it in.
 */
 void PluginFogpad::sampleRateChanged(double newSampleRate) {
-    reverbProcess = new ReverbProcess( 2, newSampleRate );
-
-    syncModel();
+    fRequestedSampleRate.store(newSampleRate);
+    requestWork();
 }
 
 /**
@@ -250,23 +274,68 @@ void PluginFogpad::setParameterValue(uint32_t index, float value) {
         DISTRHO_SAFE_ASSERT_RETURN(false, );
     }
 
-    syncModel();
+    // the process is updated by the audio thread (see run())
+    fParametersChanged.store(true);
 }
 
 // -----------------------------------------------------------------------
 // Process
 
 void PluginFogpad::activate() {
-    // plugin is activated
-}
+    // the audio thread does not run while the plugin is deactivated (which is also when DPF
+    // changes the sample rate), as such the pending work is completed here before returning
+    collectRetiredProcess();
+
+    double sampleRate = fRequestedSampleRate.exchange(0.0);
+    ReverbProcess* process = fPendingProcess.exchange(nullptr);
+
+    if (sampleRate > 0.0) {
+        delete process;
+        process = createProcess(sampleRate);
+    }
 
+    if (process != nullptr) {
+        delete reverbProcess;
+        reverbProcess = process;
+        fActiveProcess.store(process);
+    }
+
+    fParametersChanged.store(false);
+    syncModel();
 
+    // size the buffers for the largest block the host will provide so no allocations are
+    // made during processing (this only reallocates when the block size has changed)
+    reverbProcess->setMaxBufferSize( getBufferSize() );
+
+    if (reverbProcess->wantsRecordBuffer())
+        reverbProcess->createRecordBuffer();
+
+    startWorker();
+}
+
+void PluginFogpad::deactivate() {
+    stopWorker();
+}
 
 void PluginFogpad::run(const float** inputs, float** outputs, uint32_t frames) {
     //-------------------------------------
     //---Process Audio---------------------
     //-------------------------------------
 
+    // flush denormals to zero for the duration of this process cycle
+    // (the decaying reverb tail would otherwise stall the CPU)
+    DenormalGuard denormalGuard;
+
+    // debug builds assert that no heap allocations are made during processing
+    AllocationGuard allocationGuard;
+
+    // pick up the process created for a changed sample rate (if any)
+    swapProcess();
+
+    // apply the parameter changes made since the previous process cycle
+    if (fParametersChanged.exchange(false))
+        syncModel();
+
     int32 numInChannels  = DISTRHO_PLUGIN_NUM_INPUTS;
     int32 numOutChannels = DISTRHO_PLUGIN_NUM_OUTPUTS;
 
@@ -278,31 +347,154 @@ void PluginFogpad::run(const float** inputs, float** outputs, uint32_t frames) {
 
     // output flags
     outputGain = reverbProcess->limiter->getLinearGR();
+
+    // drift has been enabled, have the worker create the record buffer
+    if (reverbProcess->wantsRecordBuffer())
+        requestWork();
 }
 
 // -----------------------------------------------------------------------
 
+ReverbProcess* PluginFogpad::createProcess(double sampleRate)
+{
+    ReverbProcess* process = new ReverbProcess( 2, sampleRate, getBufferSize() );
+
+    // the recorded signal is already crushed and decimated, store it in 16-bit
+    process->setRecordFormat( RecordBuffer::INT16 );
+
+    // the drift history length and the memory budget of each instance are deployment settings,
+    // e.g. render nodes hosting many instances can limit these through the environment
+
+    if ( const char* recordTime = getenv( "FOGPAD_RECORD_TIME_MS" ))
+        process->setRecordTime(( float ) atof( recordTime ));
+
+    if ( const char* memoryBudget = getenv( "FOGPAD_MEMORY_BUDGET_KB" )) {
+        long kilobytes = atol( memoryBudget );
+        if ( kilobytes > 0 )
+            process->setMemoryBudget(( size_t ) kilobytes * 1024 );
+    }
+    return process;
+}
+
+void PluginFogpad::startWorker()
+{
+    if ( fWorker.joinable() )
+        return;
+
+    fWorkerRunning.store( true );
+    fWorkRequested.store( false );
+    fWorker = std::thread( &PluginFogpad::work, this );
+}
+
+void PluginFogpad::stopWorker()
+{
+    if ( !fWorker.joinable() )
+        return;
+
+    fWorkerRunning.store( false );
+    fWorkerSignal.post();
+    fWorker.join();
+}
+
+void PluginFogpad::requestWork()
+{
+    // only signal once until the worker has picked up the request
+
+    if ( !fWorkRequested.exchange( true ))
+        fWorkerSignal.post();
+}
+
+void PluginFogpad::work()
+{
+    while ( true )
+    {
+        fWorkerSignal.wait();
+
+        if ( !fWorkerRunning.load() )
+            break;
+
+        // requests made from here on signal the worker again
+        fWorkRequested.store( false );
+
+        collectRetiredProcess();
+
+        double sampleRate = fRequestedSampleRate.exchange( 0.0 );
+
+        if ( sampleRate > 0.0 ) {
+            ReverbProcess* process = createProcess( sampleRate );
+            syncModel( process );
+
+            if ( process->wantsRecordBuffer() )
+                process->createRecordBuffer();
+
+            // publish the process, replacing one that was built earlier but not yet picked up
+            delete fPendingProcess.exchange( process );
+        }
+
+        // the process in use by the audio thread is only deleted by this thread,
+        // as such it remains valid for the duration of this iteration
+
+        ReverbProcess* process = fActiveProcess.load();
+
+        if ( process->wantsRecordBuffer() )
+            process->createRecordBuffer();
+    }
+}
+
+void PluginFogpad::swapProcess()
+{
+    // the replaced process can only be handed back once the previous one has been collected
+
+    if ( fPendingProcess.load() == nullptr || fRetiredProcess.load() != nullptr )
+        return;
+
+    ReverbProcess* process = fPendingProcess.exchange( nullptr );
+
+    if ( process == nullptr )
+        return;
+
+    fRetiredProcess.store( reverbProcess );
+    reverbProcess = process;
+    fActiveProcess.store( process );
+
+    // have the worker delete the replaced process
+    requestWork();
+
+    // carry over parameter changes made while the process was being built (allocation free)
+    syncModel();
+}
+
+void PluginFogpad::collectRetiredProcess()
+{
+    delete fRetiredProcess.exchange( nullptr );
+}
+
 void PluginFogpad::syncModel()
 {
-    reverbProcess->setRoomSize( fReverbSize );
-    reverbProcess->setWidth( fReverbWidth );
-    reverbProcess->setDry( fReverbDryMix );
-    reverbProcess->setWet( fReverbWetMix );
-    reverbProcess->setMode( fReverbFreeze );
-    reverbProcess->setPlaybackRate( fReverbPlaybackRate );
+    syncModel( reverbProcess );
+}
+
+void PluginFogpad::syncModel(ReverbProcess* process)
+{
+    process->setRoomSize( fReverbSize );
+    process->setWidth( fReverbWidth );
+    process->setDry( fReverbDryMix );
+    process->setWet( fReverbWetMix );
+    process->setMode( fReverbFreeze );
+    process->setPlaybackRate( fReverbPlaybackRate );
 
-    reverbProcess->bitCrusherPostMix = Calc::toBool( fBitResolutionChain );
+    process->bitCrusherPostMix = Calc::toBool( fBitResolutionChain );
 
-    reverbProcess->bitCrusher->setAmount( fBitResolution );
-    reverbProcess->bitCrusher->setLFO( fLFOBitResolution, fLFOBitResolutionDepth );
+    process->bitCrusher->setAmount( fBitResolution );
+    process->bitCrusher->setLFO( fLFOBitResolution, fLFOBitResolutionDepth );
 
     // invert the decimator range 0 == max bits (no distortion), 1 == min bits (severely distorted)
     float scaledDecimator = abs( fDecimator - 1.0f );
     int decimation = ( int )( scaledDecimator * 32.f );
-    reverbProcess->decimator->setBits( decimation );
-    reverbProcess->decimator->setRate( scaledDecimator );
+    process->decimator->setBits( decimation );
+    process->decimator->setRate( scaledDecimator );
 
-    reverbProcess->filter->updateProperties( fFilterCutoff, fFilterResonance, fLFOFilter, fLFOFilterDepth );
+    process->filter->updateProperties( fFilterCutoff, fFilterResonance, fLFOFilter, fLFOFilterDepth );
 }
 
 // -----------------------------------------------------------------------
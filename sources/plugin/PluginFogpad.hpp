@@ -27,6 +27,9 @@
 #include "DistrhoPlugin.hpp"
 #include "reverbprocess.h"
 #include "global.h"
+#include "threadsignal.h"
+#include <atomic>
+#include <thread>
 
 namespace Igorski {
 
@@ -97,6 +100,7 @@ protected:
     // Process
 
     void activate() override;
+    void deactivate() override;
 
     void run(const float**, float** outputs, uint32_t frames) override;
 
@@ -104,32 +108,63 @@ protected:
     // -------------------------------------------------------------------
 
 private:
-    float fReverbSize;
-    float fReverbWidth;
-    float fReverbDryMix;
-    float fReverbWetMix;
-    float fReverbFreeze;
-    float fReverbPlaybackRate;
-
-    float fBitResolution;
-    float fBitResolutionChain;
-    float fLFOBitResolution;
-    float fLFOBitResolutionDepth;
-
-    float fDecimator;
-
-    float fFilterCutoff;
-    float fFilterResonance;
-    float fLFOFilter;
-    float fLFOFilterDepth;
-
-    float outputGain; // for visualizing output gain in DAW
-
-    Igorski::ReverbProcess* reverbProcess;
-
-    // synchronize the processors model with UI led changes
+    // the parameters can be changed from any thread, the audio thread applies them
+    // onto the process at the start of the next process cycle (see syncModel())
+
+    std::atomic<float> fReverbSize;
+    std::atomic<float> fReverbWidth;
+    std::atomic<float> fReverbDryMix;
+    std::atomic<float> fReverbWetMix;
+    std::atomic<float> fReverbFreeze;
+    std::atomic<float> fReverbPlaybackRate;
+
+    std::atomic<float> fBitResolution;
+    std::atomic<float> fBitResolutionChain;
+    std::atomic<float> fLFOBitResolution;
+    std::atomic<float> fLFOBitResolutionDepth;
+
+    std::atomic<float> fDecimator;
+
+    std::atomic<float> fFilterCutoff;
+    std::atomic<float> fFilterResonance;
+    std::atomic<float> fLFOFilter;
+    std::atomic<float> fLFOFilterDepth;
+
+    std::atomic<bool> fParametersChanged; // whether the above have changed since the last syncModel()
+
+    std::atomic<float> outputGain; // for visualizing output gain in DAW
+
+    Igorski::ReverbProcess* reverbProcess; // only to be used by the audio thread (or while deactivated)
+
+    // the worker thread makes the allocations the audio thread must not make. Upon sample rate
+    // change it creates a new process which is handed to the audio thread via fPendingProcess.
+    // The audio thread hands the process it replaced back via fRetiredProcess, where the worker
+    // deletes it. The worker also creates the drift record buffer once Wobble leaves neutral.
+    // The worker sleeps until it is signalled through requestWork() and only runs while the
+    // plugin is activated (activate() completes the work that is pending at that time)
+
+    std::thread fWorker;
+    std::atomic<bool> fWorkerRunning;
+    std::atomic<bool> fWorkRequested;                      // whether fWorkerSignal has been posted
+    Igorski::ThreadSignal fWorkerSignal;
+    std::atomic<double> fRequestedSampleRate;              // 0 when no change is pending
+    std::atomic<Igorski::ReverbProcess*> fActiveProcess;   // reverbProcess, as seen by the worker
+    std::atomic<Igorski::ReverbProcess*> fPendingProcess;
+    std::atomic<Igorski::ReverbProcess*> fRetiredProcess;
+
+    Igorski::ReverbProcess* createProcess(double sampleRate);
+    void startWorker();
+    void stopWorker();
+    void requestWork(); // lock-free, can be called from the audio thread
+    void work();        // runs on the worker thread
+    void swapProcess(); // runs on the audio thread, lock-free
+    void collectRetiredProcess();
+
+    // synchronize the processors model with UI led changes (on the audio thread, or
+    // for a process that is not yet in use)
 
     void syncModel();
+    void syncModel(Igorski::ReverbProcess* process);
 
     // -------------------------------------------------------------------
 
@@ -0,0 +1,247 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "recordbuffer.h"
+#include "simd.h"
+#include <algorithm>
+#include <limits.h>
+#include <math.h>
+#include <string.h>
+
+namespace Igorski {
+
+constexpr float RecordBuffer::INT16_SCALE;
+const int RecordBuffer::PADDING;
+const int RecordBuffer::READ_BLOCK;
+
+RecordBuffer::RecordBuffer( int aAmountOfChannels, int aSize, Format aFormat )
+{
+    amountOfChannels = aAmountOfChannels;
+    size             = aSize;
+    format           = aFormat;
+
+    size_t sampleSize = ( format == INT16 ) ? sizeof( int16_t ) : sizeof( float );
+    _channelSize      = Arena::align(( size + PADDING * 2 ) * sampleSize ) / sampleSize;
+
+    // the arena memory is zeroed (e.g. silent)
+
+    _arena.allocate( _channelSize * sampleSize * amountOfChannels );
+    _memory = static_cast<char*>( _arena.take( _channelSize * sampleSize * amountOfChannels ));
+}
+
+/* public methods */
+
+void RecordBuffer::write( float** inputs, int index, int n )
+{
+    for ( int c = 0; c < amountOfChannels; ++c ) {
+        writeChannel( c, index, inputs[ c ], n );
+    }
+}
+
+double RecordBuffer::read( double position, float rate, float** outputs, int n, Interpolation interpolation )
+{
+    if ( format == INT16 ) {
+        return readSamples<int16_t>( position, rate, outputs, n, interpolation );
+    }
+    return readSamples<float>( position, rate, outputs, n, interpolation );
+}
+
+size_t RecordBuffer::getSize()
+{
+    return _arena.getSize();
+}
+
+int RecordBuffer::getMaxSize( int amountOfChannels, size_t bytes, Format format )
+{
+    // each channel occupies a multiple of the cache line size, including its padding
+
+    size_t sampleSize   = ( format == INT16 ) ? sizeof( int16_t ) : sizeof( float );
+    size_t channelBytes = ( bytes / amountOfChannels ) / Arena::ALIGNMENT * Arena::ALIGNMENT;
+    size_t size         = channelBytes / sampleSize;
+
+    return ( size > PADDING * 2 ) ? ( int ) std::min( size - PADDING * 2, ( size_t ) INT_MAX ) : 0;
+}
+
+/* private methods */
+
+void RecordBuffer::writeChannel( int channel, int index, const float* input, int n )
+{
+    if ( format == FLOAT32 ) {
+        memcpy( getChannel<float>( channel ) + index, input, n * sizeof( float ));
+        pad( getChannel<float>( channel ), index, n );
+        return;
+    }
+
+    // convert to 16-bit, out of range values are clamped (the same way on every path)
+
+    int16_t* output = getChannel<int16_t>( channel ) + index;
+    int i = 0;
+
+#if defined(FOGPAD_SIMD_AVX) || defined(FOGPAD_SIMD_SSE)
+    __m128 scale = _mm_set1_ps( INT16_SCALE );
+    __m128 upper = _mm_set1_ps( 1.f );
+    __m128 lower = _mm_set1_ps( -1.f );
+    for ( ; i + 8 <= n; i += 8 ) {
+        // clamp before scaling, as _mm_cvtps_epi32 returns INT_MIN for values beyond the int range
+        __m128 first  = _mm_min_ps( upper, _mm_max_ps( lower, _mm_loadu_ps( input + i )));
+        __m128 second = _mm_min_ps( upper, _mm_max_ps( lower, _mm_loadu_ps( input + i + 4 )));
+        __m128i low  = _mm_cvtps_epi32( _mm_mul_ps( first,  scale ));
+        __m128i high = _mm_cvtps_epi32( _mm_mul_ps( second, scale ));
+        _mm_storeu_si128( reinterpret_cast<__m128i*>( output + i ), _mm_packs_epi32( low, high ));
+    }
+#elif defined(FOGPAD_SIMD_NEON)
+    float32x4_t scale = vdupq_n_f32( INT16_SCALE );
+    float32x4_t upper = vdupq_n_f32( 1.f );
+    float32x4_t lower = vdupq_n_f32( -1.f );
+    for ( ; i + 8 <= n; i += 8 ) {
+        float32x4_t first  = vminq_f32( upper, vmaxq_f32( lower, vld1q_f32( input + i )));
+        float32x4_t second = vminq_f32( upper, vmaxq_f32( lower, vld1q_f32( input + i + 4 )));
+#if defined(__aarch64__)
+        int32x4_t low  = vcvtnq_s32_f32( vmulq_f32( first,  scale ));
+        int32x4_t high = vcvtnq_s32_f32( vmulq_f32( second, scale ));
+#else
+        // ARMv7 has no rounding conversion, truncate instead
+        int32x4_t low  = vcvtq_s32_f32( vmulq_f32( first,  scale ));
+        int32x4_t high = vcvtq_s32_f32( vmulq_f32( second, scale ));
+#endif
+        vst1q_s16( output + i, vcombine_s16( vqmovn_s32( low ), vqmovn_s32( high )));
+    }
+#endif
+    for ( ; i < n; ++i ) {
+        output[ i ] = ( int16_t ) lrintf( std::min( 1.f, std::max( -1.f, input[ i ] )) * INT16_SCALE );
+    }
+    pad( getChannel<int16_t>( channel ), index, n );
+}
+
+template <typename T>
+void RecordBuffer::pad( T* samples, int index, int n )
+{
+    // the samples at the start of the ring are repeated after its end and vice versa
+
+    for ( int i = index; i < std::min( index + n, PADDING ); ++i ) {
+        samples[ size + i ] = samples[ i ];
+    }
+    for ( int i = std::max( index, size - PADDING ); i < index + n; ++i ) {
+        samples[ i - size ] = samples[ i ];
+    }
+}
+
+template <typename T>
+double RecordBuffer::readSamples( double position, float rate, float** outputs, int n, Interpolation interpolation )
+{
+    // the read head is shared by all channels: the sample offsets and fractions are
+    // calculated once per block, after which the samples surrounding each read position
+    // are gathered into frame-major scratch memory for each channel (the padding ensures
+    // these never wrap) and the interpolation is calculated for the whole block at once
+
+    int   offsets[ READ_BLOCK ];
+    float s0[ READ_BLOCK ], s1[ READ_BLOCK ], s2[ READ_BLOCK ], s3[ READ_BLOCK ], frac[ READ_BLOCK ];
+    bool hermite = ( interpolation == HERMITE );
+
+    for ( int done = 0; done < n; )
+    {
+        // split the block where the read position wraps around the end of the ring
+
+        int length = std::min( n - done, READ_BLOCK );
+        length     = std::min( length, ( int ) ceil(( size - position ) / rate ));
+
+        // positions are calculated relative to the integer part of the start position
+        // to keep single precision accuracy regardless of the size of the ring
+
+        int base     = ( int ) position;
+        float offset = ( float )( position - base );
+
+        for ( int i = 0; i < length; ++i ) {
+            float relative = offset + rate * i;
+            int t = ( int ) relative;
+
+            offsets[ i ] = base + t;
+            frac   [ i ] = relative - t;
+        }
+
+        for ( int c = 0; c < amountOfChannels; ++c ) {
+            const T* samples = getChannel<T>( c );
+
+            for ( int i = 0; i < length; ++i ) {
+                const T* sample = samples + offsets[ i ];
+
+                s1[ i ] = toFloat( sample[ 0 ] );
+                s2[ i ] = toFloat( sample[ 1 ] );
+
+                if ( hermite ) {
+                    s0[ i ] = toFloat( sample[ -1 ] );
+                    s3[ i ] = toFloat( sample[ 2 ] );
+                }
+            }
+            interpolate( s0, s1, s2, s3, frac, outputs[ c ] + done, length, hermite );
+        }
+
+        if (( position += ( double ) rate * length ) >= size ) {
+            position -= size;
+        }
+        done += length;
+    }
+    return position;
+}
+
+void RecordBuffer::interpolate( const float* s0, const float* s1, const float* s2, const float* s3,
+                                const float* frac, float* output, int n, bool hermite )
+{
+    int i = 0;
+
+    if ( hermite ) {
+        const SIMD::vfloat half    = SIMD::set1( .5f );
+        const SIMD::vfloat oneHalf = SIMD::set1( 1.5f );
+        const SIMD::vfloat two     = SIMD::set1( 2.f );
+        const SIMD::vfloat twoHalf = SIMD::set1( 2.5f );
+
+        for ( ; i + SIMD::WIDTH <= n; i += SIMD::WIDTH ) {
+            SIMD::vfloat x0 = SIMD::load( s0 + i ), x1 = SIMD::load( s1 + i );
+            SIMD::vfloat x2 = SIMD::load( s2 + i ), x3 = SIMD::load( s3 + i );
+            SIMD::vfloat f  = SIMD::load( frac + i );
+
+            SIMD::vfloat c1 = SIMD::mul( half, SIMD::sub( x2, x0 ));
+            SIMD::vfloat c2 = SIMD::sub( SIMD::madd( two, x2, SIMD::sub( x0, SIMD::mul( twoHalf, x1 ))), SIMD::mul( half, x3 ));
+            SIMD::vfloat c3 = SIMD::madd( half, SIMD::sub( x3, x0 ), SIMD::mul( oneHalf, SIMD::sub( x1, x2 )));
+
+            SIMD::store( output + i, SIMD::madd( SIMD::madd( SIMD::madd( c3, f, c2 ), f, c1 ), f, x1 ));
+        }
+        for ( ; i < n; ++i ) {
+            float c1 = .5f * ( s2[ i ] - s0[ i ] );
+            float c2 = s0[ i ] - 2.5f * s1[ i ] + 2.f * s2[ i ] - .5f * s3[ i ];
+            float c3 = .5f * ( s3[ i ] - s0[ i ] ) + 1.5f * ( s1[ i ] - s2[ i ] );
+
+            output[ i ] = (( c3 * frac[ i ] + c2 ) * frac[ i ] + c1 ) * frac[ i ] + s1[ i ];
+        }
+        return;
+    }
+
+    for ( ; i + SIMD::WIDTH <= n; i += SIMD::WIDTH ) {
+        SIMD::vfloat x1 = SIMD::load( s1 + i );
+        SIMD::store( output + i, SIMD::madd( SIMD::sub( SIMD::load( s2 + i ), x1 ), SIMD::load( frac + i ), x1 ));
+    }
+    for ( ; i < n; ++i ) {
+        output[ i ] = s1[ i ] + ( s2[ i ] - s1[ i ] ) * frac[ i ];
+    }
+}
+
+}
@@ -0,0 +1,109 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __RECORDBUFFER_H_INCLUDED__
+#define __RECORDBUFFER_H_INCLUDED__
+
+#include "arena.h"
+#include <stdint.h>
+
+namespace Igorski {
+/**
+ * RecordBuffer holds the recorded history of the input signal used by drift mode
+ * as a ring of given size per channel. The samples can be stored as 32-bit floats
+ * or in a compact 16-bit format, which halves the memory footprint (and the
+ * bandwidth used when recording and reading). All channels share one allocation
+ *
+ * Each ring is padded with copies of the samples at its opposite end, so
+ * interpolated reads never have to wrap their indices
+ */
+class RecordBuffer
+{
+    public:
+        enum Format {
+            FLOAT32,
+            INT16
+        };
+
+        enum Interpolation {
+            LINEAR,
+            HERMITE // 4-point, 3rd-order
+        };
+
+        RecordBuffer( int aAmountOfChannels, int aSize, Format aFormat );
+
+        int amountOfChannels;
+        int size;
+        Format format;
+
+        // write n samples of each channel into the rings starting at index, the write should
+        // not wrap around the end of the ring (split it at the end when necessary)
+
+        void write( float** inputs, int index, int n );
+
+        // read n samples of each channel into outputs, starting at given (fractional) position
+        // and advancing by rate for each sample. All channels are read by the same head, so the
+        // read positions are calculated once for all channels. Returns the position after the
+        // last read sample (wrapped into the ring). rate must be positive
+
+        double read( double position, float rate, float** outputs, int n, Interpolation interpolation );
+
+        // access to the storage of a channel, where T matches the format
+
+        template <typename T>
+        T* getChannel( int channel )
+        {
+            return reinterpret_cast<T*>( _memory ) + ( size_t ) channel * _channelSize + PADDING;
+        }
+
+        static inline float toFloat( float sample )   { return sample; }
+        static inline float toFloat( int16_t sample ) { return ( float ) sample * ( 1.f / INT16_SCALE ); }
+
+        size_t getSize(); // in bytes
+
+        // the largest ring size (per channel) of which given amount of channels fit in given amount of bytes
+
+        static int getMaxSize( int amountOfChannels, size_t bytes, Format format );
+
+    private:
+        static constexpr float INT16_SCALE = 32767.f;
+        static const int PADDING    = 4; // guard samples on either side of each ring
+        static const int READ_BLOCK = 64;
+
+        void writeChannel( int channel, int index, const float* input, int n );
+
+        template <typename T>
+        void pad( T* samples, int index, int n );
+
+        template <typename T>
+        double readSamples( double position, float rate, float** outputs, int n, Interpolation interpolation );
+
+        static void interpolate( const float* s0, const float* s1, const float* s2, const float* s3,
+                                 const float* frac, float* output, int n, bool hermite );
+
+        Arena _arena;
+        char* _memory;
+        size_t _channelSize; // in samples, channels are spaced by a multiple of the cache line size
+};
+}
+
+#endif
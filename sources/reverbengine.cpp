@@ -0,0 +1,313 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "reverbengine.h"
+#include "calc.h"
+#include <math.h>
+#include <limits.h>
+#include <algorithm>
+
+namespace Igorski {
+
+constexpr float ReverbEngineBase::MIN_RECORD_TIME_MS;
+constexpr float ReverbEngineBase::MAX_RECORD_TIME_MS;
+
+ReverbEngineBase::ReverbEngineBase( int amountOfChannels, float sampleRate, int maxBufferSize ) :
+    _bitCrusher( 8, .5f, .5f, sampleRate ),
+    _decimator( 32, 0.f ),
+    _filter( sampleRate ),
+    _limiter( 10.f, 500.f, .6f ) {
+    _sampleRate = sampleRate;
+
+    // jpc: resolve use of uninitialized memory
+    _mode = INITIAL_MODE;
+
+    _amountOfChannels = amountOfChannels;
+
+    _recordIndex  = 0;
+    _recordTime   = DEFAULT_RECORD_TIME_MS;
+    _memoryBudget = 0;
+    _playbackReadIndex = 0.0;
+
+    // will be lazily created once drift is enabled
+    _recordBuffer   = nullptr;
+    _recordFormat   = RecordBuffer::FLOAT32;
+
+    _driftInterpolation = RecordBuffer::LINEAR;
+    _driftRequested = false;
+
+    _recording       = false;
+    _recordedSamples = 0;
+    _driftPreroll    = std::max( 1, Calc::millisecondsToBuffer( DRIFT_PREROLL_MS, sampleRate ));
+    _driftMix        = 0.f;
+    _driftFadeStep   = 1.f / ( float ) _driftPreroll;
+
+    bitCrusher = &_bitCrusher;
+    decimator  = &_decimator;
+    filter     = &_filter;
+    limiter    = &_limiter;
+
+    // the oscillators of the effects are rendered once per block by the modulation bus
+
+    _modulation.setSource( ModulationBus::FILTER_LFO,      &_filter.lfo );
+    _modulation.setSource( ModulationBus::BIT_CRUSHER_LFO, &_bitCrusher.lfo );
+
+    bitCrusherPostMix = false;
+
+    _sleeping         = false;
+    _silentSamples    = 0;
+    _sleepHoldSamples = 0;
+
+    setWet     ( INITIAL_WET );
+    setRoomSize( INITIAL_ROOM );
+    setDry     ( INITIAL_DRY );
+    setDamp    ( INITIAL_DAMP );
+    setWidth   ( INITIAL_WIDTH );
+    setMode    ( INITIAL_MODE );
+
+    // the sample memory is allocated by the derived ReverbEngine
+
+    _preMix        = { nullptr, amountOfChannels, 0, 0 };
+    _postMix       = { nullptr, amountOfChannels, 0, 0 };
+    _maxBufferSize = std::max( 1, maxBufferSize );
+    _playbackRate  = 1.f;
+}
+
+ReverbEngineBase::~ReverbEngineBase() {
+    delete _recordBuffer.load();
+}
+
+void ReverbEngineBase::setMaxBufferSize( int maxBufferSize )
+{
+    maxBufferSize = std::max( 1, maxBufferSize );
+
+    if ( maxBufferSize == _maxBufferSize )
+        return;
+
+    _maxBufferSize = maxBufferSize;
+    allocateMemory();
+}
+
+bool ReverbEngineBase::wantsRecordBuffer()
+{
+    return _driftRequested.load() && _recordBuffer.load() == nullptr && getRecordSize() > 0;
+}
+
+void ReverbEngineBase::createRecordBuffer()
+{
+    int size = getRecordSize();
+
+    if ( _recordBuffer.load() != nullptr || size == 0 ) {
+        return;
+    }
+    _recordBuffer.store( new RecordBuffer( _amountOfChannels, size, _recordFormat ), std::memory_order_release );
+}
+
+void ReverbEngineBase::setRecordFormat( RecordBuffer::Format format )
+{
+    _recordFormat = format;
+}
+
+void ReverbEngineBase::setDriftInterpolation( RecordBuffer::Interpolation interpolation )
+{
+    _driftInterpolation = interpolation;
+}
+
+void ReverbEngineBase::setRecordTime( float milliseconds )
+{
+    _recordTime = std::min( MAX_RECORD_TIME_MS, std::max( MIN_RECORD_TIME_MS, milliseconds ));
+}
+
+float ReverbEngineBase::getRecordTime()
+{
+    RecordBuffer* recordBuffer = _recordBuffer.load();
+    int size = ( recordBuffer != nullptr ) ? recordBuffer->size : getRecordSize();
+
+    return Calc::bufferToMilliseconds( size, _sampleRate );
+}
+
+void ReverbEngineBase::setMemoryBudget( size_t bytes )
+{
+    _memoryBudget = bytes;
+}
+
+size_t ReverbEngineBase::getMemoryFootprint()
+{
+    size_t footprint = _arena.getSize();
+
+    RecordBuffer* recordBuffer = _recordBuffer.load();
+    if ( recordBuffer != nullptr ) {
+        footprint += recordBuffer->getSize();
+    }
+    return footprint;
+}
+
+float ReverbEngineBase::getRoomSize()
+{
+    return ( _roomSize - OFFSET_ROOM ) / SCALE_ROOM;
+}
+
+void ReverbEngineBase::setRoomSize( float value )
+{
+    _roomSize = ( value * SCALE_ROOM ) + OFFSET_ROOM;
+    update();
+}
+
+float ReverbEngineBase::getDamp()
+{
+    return _damp / SCALE_DAMP;
+}
+
+void ReverbEngineBase::setDamp( float value )
+{
+    _damp = value * SCALE_DAMP;
+    update();
+}
+
+float ReverbEngineBase::getWet()
+{
+    return _wet / SCALE_WET;
+}
+
+void ReverbEngineBase::setWet( float value )
+{
+    _wet = value * SCALE_WET;
+    update();
+}
+
+float ReverbEngineBase::getDry()
+{
+    return _dry / SCALE_DRY;
+}
+
+void ReverbEngineBase::setDry( float value )
+{
+    _dry = value * SCALE_DRY;
+}
+
+float ReverbEngineBase::getWidth()
+{
+    return _width;
+}
+
+void ReverbEngineBase::setWidth( float value )
+{
+    _width = value;
+    update();
+}
+
+float ReverbEngineBase::getPlaybackRate()
+{
+    return Calc::scale( _playbackRate - MIN_PLAYBACK_RATE, 1.0f, 1.0f );
+}
+
+void ReverbEngineBase::setPlaybackRate( float value )
+{
+    // "snap" to neutral setting when roughly halfway
+    if ( value >= .48f && value <= .52f ) {
+        _playbackRate = 1.0f;
+    }
+     else {
+        _playbackRate = MIN_PLAYBACK_RATE + Calc::scale(value, 1.0f, 1.0f );
+    }
+    _driftRequested.store( _playbackRate != 1.0f );
+}
+
+float ReverbEngineBase::getMode()
+{
+    return ( _mode >= FREEZE_MODE ) ? 1 : 0;
+}
+
+void ReverbEngineBase::setMode( float value )
+{
+    _mode = value;
+    update();
+}
+
+int ReverbEngineBase::getRecordSize()
+{
+    int size = Calc::millisecondsToBuffer( _recordTime, _sampleRate );
+
+    if ( _memoryBudget > 0 ) {
+        // the record buffer gets what remains of the budget after the other sample memory
+
+        size_t footprint = getMemoryFootprint();
+        RecordBuffer* recordBuffer = _recordBuffer.load();
+        if ( recordBuffer != nullptr ) {
+            footprint -= recordBuffer->getSize();
+        }
+        size_t available = ( _memoryBudget > footprint ) ? _memoryBudget - footprint : 0;
+        size = std::min( size, RecordBuffer::getMaxSize( _amountOfChannels, available, _recordFormat ));
+    }
+    return ( size >= Calc::millisecondsToBuffer( MIN_RECORD_TIME_MS, _sampleRate )) ? size : 0;
+}
+
+size_t ReverbEngineBase::getMixBufferSize()
+{
+    return Arena::align( _maxBufferSize * sizeof( float )) * _amountOfChannels;
+}
+
+AudioBufferView ReverbEngineBase::takeMixBuffer()
+{
+    size_t stride = Arena::align( _maxBufferSize * sizeof( float )) / sizeof( float );
+    return { _arena.take<float>( stride * _amountOfChannels ), _amountOfChannels, _maxBufferSize, stride };
+}
+
+int ReverbEngineBase::getDelaySize( int tuning, int channel )
+{
+    // tune the filter to the host environments sample rate
+    int size = ( int ) ((( float ) tuning / 44100.f ) * _sampleRate );
+    return size + ( channel * STEREO_SPREAD );
+}
+
+void ReverbEngineBase::update()
+{
+    // Recalculate internal values after parameter change
+
+    _wet1 = _wet * ( _width / 2 + 0.5f );
+    _wet2 = _wet * (( 1 - _width ) / 2 );
+
+    if ( _mode >= FREEZE_MODE ){
+        _roomSize1 = 1;
+        _damp1     = 0;
+        _gain      = MUTED;
+    }
+    else {
+        _roomSize1 = _roomSize;
+        _damp1     = _damp;
+        _gain      = FIXED_GAIN;
+    }
+
+    // the comb filters pick up the new room size and damping upon the next process cycle
+
+    // RT60 of the longest comb filter, in freeze mode the tail never decays
+
+    if ( _roomSize1 >= 1.f ) {
+        _sleepHoldSamples = INT_MAX;
+    }
+    else {
+        float delay = ( float ) getDelaySize( VST::COMB_TUNINGS[ VST::NUM_COMBS - 1 ], _amountOfChannels - 1 );
+        _sleepHoldSamples = ( int ) std::min( -3.f * delay / log10f( _roomSize1 ), ( float ) INT_MAX / 2 );
+    }
+}
+
+}
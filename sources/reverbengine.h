@@ -0,0 +1,292 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __REVERBENGINE_H_INCLUDED__
+#define __REVERBENGINE_H_INCLUDED__
+
+#include "global.h"
+#include "audiobuffer.h"
+#include "combbank.h"
+#include "allpasschain.h"
+#include "bitcrusher.h"
+#include "decimator.h"
+#include "filter.h"
+#include "limiter.h"
+#include "modulationbus.h"
+#include "arena.h"
+#include "recordbuffer.h"
+#include <atomic>
+
+namespace Igorski {
+/**
+ * ReverbEngineBase holds the parameters and effects of the reverb which
+ * do not depend on the channel layout. The processing itself is done by
+ * ReverbEngine, which is specialized at compile time for a given layout
+ */
+class ReverbEngineBase {
+
+    protected:
+        static constexpr float MUTED              = 0;
+        static constexpr float FIXED_GAIN         = 0.015f;
+        static constexpr float SCALE_WET          = 1.f;
+        static constexpr float SCALE_DRY          = 1.f;
+        static constexpr float SCALE_DAMP         = 0.4f;
+        static constexpr float SCALE_ROOM         = 0.28f;
+        static constexpr float OFFSET_ROOM        = 0.7f;
+        static constexpr float INITIAL_ROOM       = 0.5f;
+        static constexpr float INITIAL_DAMP       = 0.5f;
+        static constexpr float INITIAL_WET        = 1 / SCALE_WET;
+        static constexpr float INITIAL_DRY        = 0.5;
+        static constexpr float INITIAL_WIDTH      = 1;
+        static constexpr float INITIAL_MODE       = 0;
+        static constexpr float FREEZE_MODE        = 0.5f;
+        static constexpr int STEREO_SPREAD        = 23;
+
+        // below this level (-90 dBFS) the reverb input and output are considered silent
+
+        static constexpr float SILENCE_THRESHOLD = 0.000031623f;
+
+        // we allow only a slowdown and speed up of 100 pct
+
+        static constexpr float MIN_PLAYBACK_RATE = 0.5f;
+        static constexpr float MAX_PLAYBACK_RATE = 1.5f;
+
+        // once drift is enabled, the input is recorded for this long before
+        // the drift signal is faded in (over the same duration)
+
+        static constexpr float DRIFT_PREROLL_MS = 25.f;
+
+        // the length of the drift history (the record buffer) can be configured per instance
+
+        static constexpr float DEFAULT_RECORD_TIME_MS = 5000.f;
+        static constexpr float MIN_RECORD_TIME_MS     = 250.f;
+        static constexpr float MAX_RECORD_TIME_MS     = 60000.f;
+
+    public:
+        ReverbEngineBase( int amountOfChannels, float sampleRate, int maxBufferSize );
+        virtual ~ReverbEngineBase();
+
+        // apply effect to incoming sampleBuffer contents
+
+        virtual void process( float** inBuffer, float** outBuffer, int numInChannels, int numOutChannels, int bufferSize ) = 0;
+        virtual void process( double** inBuffer, double** outBuffer, int numInChannels, int numOutChannels, int bufferSize ) = 0;
+
+        virtual void mute() = 0;
+
+        // the mix buffers hold the largest block the host will provide (as given upon
+        // construction). Changing this size reallocates all sample memory (silencing the reverb)
+        // and must not be done while processing, blocks exceeding it are processed in multiple parts
+
+        void setMaxBufferSize( int maxBufferSize );
+
+        // the record buffer for drift mode is only allocated once drift is enabled, as this
+        // allocates it should not be created on the audio thread. When wantsRecordBuffer()
+        // returns true (e.g. after a process cycle), call createRecordBuffer() from another thread
+
+        bool wantsRecordBuffer();
+        void createRecordBuffer();
+
+        // the format in which the record buffer stores its samples, only
+        // applies to a record buffer that has not been created yet
+
+        void setRecordFormat( RecordBuffer::Format format );
+
+        // the interpolation used when reading the record buffer at a varying playback rate
+
+        void setDriftInterpolation( RecordBuffer::Interpolation interpolation );
+
+        // the length of the drift history in milliseconds, only applies to a record buffer
+        // that has not been created yet. getRecordTime() returns the length of the history
+        // the record buffer has (or will be created with) after the memory budget is applied
+
+        void setRecordTime( float milliseconds );
+        float getRecordTime();
+
+        // the maximum amount of bytes the engine may allocate for its sample memory (0 is
+        // unlimited). The filters and mix buffers are always allocated, the budget limits the
+        // length of the drift history. When not even the minimum history fits, drift is unavailable
+
+        void setMemoryBudget( size_t bytes );
+
+        // the amount of bytes currently allocated for sample memory (the arena holding the
+        // filter delay lines and the mix buffers, and the record buffer once created)
+
+        size_t getMemoryFootprint();
+
+        void setRoomSize( float value );
+        float getRoomSize();
+        void setDamp( float value );
+        float getDamp();
+        void setWet( float value );
+        float getWet();
+        void setDry( float value );
+        float getDry();
+        float getWidth();
+        void setWidth( float value );
+        float getMode();
+        void setMode( float value );
+        float getPlaybackRate();
+        void setPlaybackRate( float value );
+
+        // the effects are owned by the engine (see _bitCrusher et al.)
+
+        BitCrusher* bitCrusher;
+        Decimator* decimator;
+        Filter* filter;
+        Limiter* limiter;
+
+        // whether effects are applied onto the input delay signal or onto
+        // the delayed signal itself (false = on input, true = on delay)
+
+        bool bitCrusherPostMix;
+
+    protected:
+        // the effects are held by value so an engine is a single allocation (and the
+        // state of its processing graph lies close together in memory)
+
+        BitCrusher _bitCrusher;
+        Decimator  _decimator;
+        Filter     _filter;
+        Limiter    _limiter;
+        ModulationBus _modulation;
+
+        std::atomic<RecordBuffer*> _recordBuffer; // contains the sample memory for drift mode
+        RecordBuffer::Format _recordFormat;
+        RecordBuffer::Interpolation _driftInterpolation;
+        std::atomic<bool> _driftRequested;       // whether Wobble has left neutral
+        Arena _arena;             // sample memory of the filter delay lines, the mix buffers, the filter state and modulation buffers
+        AudioBufferView _preMix;  // buffer used for the pre-delay effect mixing
+        AudioBufferView _postMix; // buffer used for the post-delay effect mixing
+        int  _amountOfChannels;
+        int  _maxBufferSize;
+        int  _recordIndex; // write position in the record buffer, shared by all channels
+        float  _recordTime;
+        size_t _memoryBudget;
+
+        int getRecordSize();               // record buffer size (per channel) within the memory budget, 0 when none fits
+
+        // (re)allocates the arena and lays out the filter delay lines and mix buffers inside it
+
+        virtual void allocateMemory() = 0;
+
+        size_t getMixBufferSize();     // size of a mix buffer in the arena in bytes
+        AudioBufferView takeMixBuffer(); // takes a (silent) mix buffer from the arena
+
+        void update();
+        int getDelaySize( int tuning, int channel ); // delay line size for given 44.1 kHz tuning
+
+        // once the input and the reverb tail have been silent for the hold time (the
+        // time the tail needs to decay by 60 dB) the reverb network is put to sleep
+
+        bool _sleeping;
+        int  _silentSamples;
+        int  _sleepHoldSamples;
+
+        float _playbackRate;
+        double _playbackReadIndex; // drift read head shared by all channels (double as single precision
+                                   // cannot hold the fraction for large buffers)
+
+        bool  _recording;       // whether the input is being recorded (only while drifting)
+        int   _recordedSamples; // amount of samples recorded since drift was enabled (up to the pre-roll)
+        int   _driftPreroll;
+        float _driftMix;        // 0 = direct input, 1 = drift signal
+        float _driftFadeStep;
+
+        float _gain;
+        float _roomSize, _roomSize1;
+        float _damp, _damp1;
+        float _wet, _wet1, _wet2;
+        float _dry;
+        float _width;
+        float _mode;
+
+        float _sampleRate;
+};
+
+/**
+ * ReverbEngine is the reverb processor for a layout known at compile time: the
+ * amount of channels, comb filters and all pass filters are template parameters,
+ * so all filter state lives in fixed-size arrays and the loops over channels
+ * and filters can be fully unrolled. The filters are tuned using the first
+ * Combs and AllPasses values of VST::COMB_TUNINGS and VST::ALLPASS_TUNINGS
+ */
+template <int Channels, int Combs = VST::NUM_COMBS, int AllPasses = VST::NUM_ALLPASSES>
+class ReverbEngine : public ReverbEngineBase {
+
+    static_assert( Channels > 0 && Channels <= VST::MAX_CHANNELS, "unsupported amount of channels" );
+    static_assert( Combs > 0 && Combs <= VST::NUM_COMBS, "no tuning available for the amount of comb filters" );
+    static_assert( AllPasses > 0 && AllPasses <= VST::NUM_ALLPASSES, "no tuning available for the amount of all pass filters" );
+
+    public:
+        ReverbEngine( float sampleRate, int maxBufferSize );
+
+        void process( float** inBuffer, float** outBuffer, int numInChannels, int numOutChannels, int bufferSize ) override;
+        void process( double** inBuffer, double** outBuffer, int numInChannels, int numOutChannels, int bufferSize ) override;
+
+        void mute() override;
+
+    protected:
+        void allocateMemory() override;
+
+    private:
+        // the comb and all pass filters hold the state for all channels, their delay
+        // lines are laid out back to back in the arena
+
+        CombBank<Channels, Combs> _combs;
+        AllPassChain<Channels, AllPasses> _allpasses;
+        float getPeak( float** buffers, int bufferSize ); // highest absolute sample value across all channels
+
+        // reads the drift signal for all channels from the record buffer (advancing the read head
+        // once) and crossfades it with the input using the current drift mix (moving towards driftTarget)
+
+        void gatherDrift( RecordBuffer* recordBuffer, float** inputs, float** outputs, int bufferSize, float driftTarget );
+
+        // splits blocks exceeding the mix buffer size into parts that fit
+
+        template <typename SampleType>
+        void run( SampleType** inBuffer, SampleType** outBuffer, int numInChannels, int numOutChannels, int bufferSize );
+
+        template <typename SampleType>
+        void runPart( SampleType** inBuffer, SampleType** outBuffer, int numInChannels, int numOutChannels, int bufferSize );
+
+        // provides the (single precision) input for each channel in inputs. When clone is true (or
+        // the input is double precision) the input is cloned into the pre-mix view, otherwise the
+        // input is read directly. The mix buffers are sized up front so this does not allocate
+
+        template <typename SampleType>
+        void prepareMixBuffers( SampleType** inBuffer, int numInChannels, AudioBufferView preMix, bool clone, float** inputs );
+
+        // whether an output channel overlaps the input of another channel
+
+        template <typename SampleType>
+        bool isAliased( SampleType** inBuffer, SampleType** outBuffer, int numChannels, int bufferSize );
+
+        // mixes the dry and wet signal of a channel into the output
+
+        template <typename DrySampleType, typename SampleType>
+        void mixChannel( const DrySampleType* dryBuffer, const float* wetBuffer, SampleType* outBuffer, int bufferSize );
+};
+}
+
+#include "reverbengine.tcc"
+
+#endif
@@ -0,0 +1,446 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2018-2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include <algorithm>
+#include <cmath>
+#include <type_traits>
+
+namespace Igorski
+{
+template <int Channels, int Combs, int AllPasses>
+ReverbEngine<Channels, Combs, AllPasses>::ReverbEngine( float sampleRate, int maxBufferSize ) :
+    ReverbEngineBase( Channels, sampleRate, maxBufferSize ) {
+    allocateMemory();
+
+    // this will initialize the buffers with silence
+    mute();
+}
+
+template <int Channels, int Combs, int AllPasses>
+void ReverbEngine<Channels, Combs, AllPasses>::process( float** inBuffer, float** outBuffer, int numInChannels,
+                                                        int numOutChannels, int bufferSize ) {
+    run<float>( inBuffer, outBuffer, numInChannels, numOutChannels, bufferSize );
+}
+
+template <int Channels, int Combs, int AllPasses>
+void ReverbEngine<Channels, Combs, AllPasses>::process( double** inBuffer, double** outBuffer, int numInChannels,
+                                                        int numOutChannels, int bufferSize ) {
+    run<double>( inBuffer, outBuffer, numInChannels, numOutChannels, bufferSize );
+}
+
+template <int Channels, int Combs, int AllPasses>
+void ReverbEngine<Channels, Combs, AllPasses>::mute()
+{
+    if ( getMode() >= FREEZE_MODE )
+        return;
+
+    _combs.mute();
+    _allpasses.mute();
+}
+
+template <int Channels, int Combs, int AllPasses>
+template <typename SampleType>
+void ReverbEngine<Channels, Combs, AllPasses>::run( SampleType** inBuffer, SampleType** outBuffer, int numInChannels,
+                                                    int numOutChannels, int bufferSize ) {
+
+    if ( bufferSize <= _maxBufferSize ) {
+        runPart( inBuffer, outBuffer, numInChannels, numOutChannels, bufferSize );
+        return;
+    }
+
+    // the host exceeded the block size it announced, process the block in parts
+
+    SampleType* inPart [ VST::MAX_CHANNELS ];
+    SampleType* outPart[ VST::MAX_CHANNELS ];
+
+    numInChannels  = std::min( numInChannels,  VST::MAX_CHANNELS );
+    numOutChannels = std::min( numOutChannels, VST::MAX_CHANNELS );
+
+    for ( int offset = 0; offset < bufferSize; offset += _maxBufferSize ) {
+        for ( int c = 0; c < numInChannels; ++c ) {
+            inPart[ c ] = inBuffer[ c ] + offset;
+        }
+        for ( int c = 0; c < numOutChannels; ++c ) {
+            outPart[ c ] = outBuffer[ c ] + offset;
+        }
+        runPart( inPart, outPart, numInChannels, numOutChannels, std::min( _maxBufferSize, bufferSize - offset ));
+    }
+}
+
+template <int Channels, int Combs, int AllPasses>
+template <typename SampleType>
+void ReverbEngine<Channels, Combs, AllPasses>::runPart( SampleType** inBuffer, SampleType** outBuffer, int numInChannels,
+                                                        int numOutChannels, int bufferSize ) {
+
+    // input and output buffers can be float or double as defined
+    // by the templates SampleType value. Internally we process
+    // audio as floats
+
+    int i;
+    float inputPeak = 0.f;
+
+    // apply the latest room size and damping values onto the comb filters
+
+    _combs.setFeedback( _roomSize1 );
+    _combs.setDamp( _damp1 );
+
+    // render the modulation of all modulated effects for this block
+
+    _modulation.setActive( ModulationBus::FILTER_LFO,      _filter.hasLFO() );
+    _modulation.setActive( ModulationBus::BIT_CRUSHER_LFO, _bitCrusher.hasLFO );
+    _modulation.render( bufferSize );
+    const float* bitCrusherModulation = _modulation.getBuffer( ModulationBus::BIT_CRUSHER_LFO );
+
+    // all channels are processed together by each stage (the effects and reverb filters
+    // keep the state of every channel side by side) so the modulation is shared by all channels
+
+    AudioBufferView preMix  = _preMix;
+    AudioBufferView postMix = _postMix;
+
+    float* preMixBuffers [ Channels ];
+    float* postMixBuffers[ Channels ];
+
+    for ( int32 c = 0; c < Channels; ++c ) {
+        postMixBuffers[ c ] = postMix.getChannel( c );
+    }
+
+    // the pre mix effects are applied onto a clone of the input. When these leave the signal
+    // untouched, single precision input is read directly instead of cloning it
+
+    bool crushPreMix = !bitCrusherPostMix && bitCrusher->isActive();
+    bool decimate    = decimator->isActive();
+
+    prepareMixBuffers( inBuffer, numInChannels, preMix.slice( 0, bufferSize ), crushPreMix || decimate, preMixBuffers );
+
+    // PRE MIX processing
+
+    if ( crushPreMix ) {
+        for ( int32 c = 0; c < Channels; ++c )
+            bitCrusher->process( preMixBuffers[ c ], bufferSize, bitCrusherModulation );
+    }
+
+    if ( decimate ) {
+        decimator->process( preMixBuffers, Channels, bufferSize );
+    }
+
+    // the input is only recorded while drifting. When drift is enabled (and its record buffer
+    // is available) the input is recorded for the pre-roll before the drift signal is faded in,
+    // the read head starts at the first recorded sample. When drift is disabled the drift
+    // signal is faded out before the recording stops
+
+    RecordBuffer* recordBuffer = _recordBuffer.load( std::memory_order_acquire );
+    bool driftEnabled = ( _playbackRate != 1.0f ) && recordBuffer != nullptr;
+
+    if ( driftEnabled && !_recording ) {
+        _recording         = true;
+        _recordedSamples   = 0;
+        _playbackReadIndex = ( double ) _recordIndex;
+    }
+    float driftTarget = ( driftEnabled && _recordedSamples >= _driftPreroll ) ? 1.f : 0.f;
+    bool hasDrift     = driftTarget > 0.f || _driftMix > 0.f;
+
+    _recording = driftEnabled || hasDrift;
+
+    if ( _recording ) {
+        // record the incoming premixed, processed signal of all channels into the record buffer
+        // (for use with drift mode), the write is split where it wraps around the end of the buffer
+
+        for ( i = 0; i < bufferSize; ) {
+            int length = std::min( bufferSize - i, recordBuffer->size - _recordIndex );
+            float* inputs[ Channels ];
+
+            for ( int32 c = 0; c < Channels; ++c )
+                inputs[ c ] = preMixBuffers[ c ] + i;
+
+            recordBuffer->write( inputs, _recordIndex, length );
+
+            i += length;
+            if (( _recordIndex += length ) >= recordBuffer->size ) {
+                _recordIndex = 0;
+            }
+        }
+    }
+
+    // gather the reverb input into the post mix buffers, when not drifting the input
+    // is taken directly from the pre mix buffers as it is scaled by the gain
+
+    if ( hasDrift ) {
+        gatherDrift( recordBuffer, preMixBuffers, postMixBuffers, bufferSize, driftTarget );
+    }
+
+    for ( int32 c = 0; c < Channels; ++c )
+    {
+        const float* channelInput   = hasDrift ? postMixBuffers[ c ] : preMixBuffers[ c ];
+        float* channelPostMixBuffer = postMixBuffers[ c ];
+
+        for ( i = 0; i < bufferSize; ++i ) {
+            float sample = channelInput[ i ];
+            inputPeak = std::max( inputPeak, std::fabs( sample ));
+            channelPostMixBuffer[ i ] = sample * _gain;
+        }
+    }
+    _recordedSamples = std::min( _driftPreroll, _recordedSamples + bufferSize );
+
+    // wake up the reverb network as soon as it receives input again (the input is
+    // gathered before the network runs, so no part of the signal is missed)
+
+    if ( inputPeak > SILENCE_THRESHOLD || _mode >= FREEZE_MODE ) {
+        _silentSamples = 0;
+        _sleeping      = false;
+    }
+
+    if ( _sleeping ) {
+        // the tail has decayed, only the dry signal remains
+        for ( int32 c = 0; c < Channels; ++c )
+            std::fill( postMixBuffers[ c ], postMixBuffers[ c ] + bufferSize, 0.f );
+    }
+    else {
+        // ---- REVERB process applied onto the post mix buffers
+
+        // Accumulate comb filters in parallel (streamed over the whole block)
+        _combs.processBlock( postMixBuffers, postMixBuffers, bufferSize );
+
+        // Feed through allPasses in series
+        _allpasses.processBlock( postMixBuffers, postMixBuffers, bufferSize );
+
+        // keep track of how long the input and the reverb tail have been silent
+
+        if ( inputPeak <= SILENCE_THRESHOLD && getPeak( postMixBuffers, bufferSize ) <= SILENCE_THRESHOLD ) {
+            if (( _silentSamples += bufferSize ) >= _sleepHoldSamples ) {
+                _sleeping = true;
+            }
+        }
+        else {
+            _silentSamples = 0;
+        }
+
+        // POST MIX processing
+        // apply the post mix effect processing
+
+        filter->process( postMix.slice( 0, bufferSize ), _modulation.getBuffer( ModulationBus::FILTER_LFO ));
+
+        if ( bitCrusherPostMix ) {
+            for ( int32 c = 0; c < Channels; ++c )
+                bitCrusher->process( postMixBuffers[ c ], bufferSize, bitCrusherModulation );
+        }
+    }
+
+    // mix the input and processed post mix buffers into the output buffer
+
+    int numChannels = std::min( Channels, std::min( numInChannels, numOutChannels ));
+
+    // hosts can supply the same buffers for in- and output (e.g. VST2 in Ableton Live), which
+    // is safe as each input sample is read before the output sample is written. Only when an
+    // output channel overlaps the input of another channel, the dry signal is saved up front
+    // (the pre mix buffers are no longer needed at this point)
+
+    bool saveDry = isAliased( inBuffer, outBuffer, numChannels, bufferSize );
+
+    for ( int32 c = 0; c < numChannels && saveDry; ++c ) {
+        float* savedDry = preMix.getChannel( c );
+        for ( i = 0; i < bufferSize; ++i ) {
+            savedDry[ i ] = ( float ) inBuffer[ c ][ i ];
+        }
+    }
+
+    for ( int32 c = 0; c < numChannels; ++c )
+    {
+        SampleType* channelOutBuffer = outBuffer[ c ];
+        float* channelPostMixBuffer  = postMixBuffers[ c ];
+
+        if ( saveDry ) {
+            mixChannel( preMix.getChannel( c ), channelPostMixBuffer, channelOutBuffer, bufferSize );
+        } else {
+            mixChannel( inBuffer[ c ], channelPostMixBuffer, channelOutBuffer, bufferSize );
+        }
+    }
+
+    // limit the output signal as it can get quite hot
+    limiter->process<SampleType>( outBuffer, bufferSize, numOutChannels );
+}
+
+template <int Channels, int Combs, int AllPasses>
+template <typename SampleType>
+void ReverbEngine<Channels, Combs, AllPasses>::prepareMixBuffers( SampleType** inBuffer, int numInChannels, AudioBufferView preMix,
+                                                                  bool clone, float** inputs )
+{
+    // clone the in buffer contents
+    // note the clone is always cast to float as it is
+    // used for internal processing (see ReverbEngine::runPart)
+    // channels the host provides no input for are silent
+
+    bool singlePrecision = std::is_same<SampleType, float>::value;
+    int bufferSize       = preMix.bufferSize;
+
+    for ( int c = 0; c < Channels; ++c ) {
+
+        float* channelPremixBuffer = preMix.getChannel( c );
+        inputs[ c ] = channelPremixBuffer;
+
+        if ( c >= numInChannels ) {
+            std::fill( channelPremixBuffer, channelPremixBuffer + bufferSize, 0.f );
+            continue;
+        }
+
+        if ( singlePrecision && !clone ) {
+            // the input is only read, no need to clone it
+            inputs[ c ] = reinterpret_cast<float*>( inBuffer[ c ] );
+            continue;
+        }
+        SampleType* inChannelBuffer = ( SampleType* ) inBuffer[ c ];
+
+        for ( int i = 0; i < bufferSize; ++i ) {
+            // clone into the pre mix buffer for pre-processing
+            channelPremixBuffer[ i ] = ( float ) inChannelBuffer[ i ];
+        }
+    }
+}
+
+template <int Channels, int Combs, int AllPasses>
+template <typename SampleType>
+bool ReverbEngine<Channels, Combs, AllPasses>::isAliased( SampleType** inBuffer, SampleType** outBuffer,
+                                                          int numChannels, int bufferSize )
+{
+    for ( int out = 0; out < numChannels; ++out ) {
+        for ( int in = 0; in < numChannels; ++in ) {
+            if ( in != out && outBuffer[ out ] < inBuffer[ in ] + bufferSize && inBuffer[ in ] < outBuffer[ out ] + bufferSize ) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+template <int Channels, int Combs, int AllPasses>
+template <typename DrySampleType, typename SampleType>
+void ReverbEngine<Channels, Combs, AllPasses>::mixChannel( const DrySampleType* dryBuffer, const float* wetBuffer,
+                                                           SampleType* outBuffer, int bufferSize )
+{
+    for ( int i = 0; i < bufferSize; ++i ) {
+
+        // before writing to the out buffer we take a snapshot of the current in sample
+        // value as the in and out buffer can be the same
+        SampleType inSample = ( SampleType ) dryBuffer[ i ];
+
+        // wet mix (e.g. the effected signal)
+        outBuffer[ i ] = ( SampleType ) wetBuffer[ i ] * _wet1;
+
+        // dry mix (e.g. mix in the input signal)
+        outBuffer[ i ] += ( inSample * _dry );
+    }
+}
+
+/* private methods */
+
+template <int Channels, int Combs, int AllPasses>
+void ReverbEngine<Channels, Combs, AllPasses>::gatherDrift( RecordBuffer* recordBuffer, float** inputs, float** outputs,
+                                                            int bufferSize, float driftTarget )
+{
+    // read the block from the pre-recorded buffer at the playback rate so we can vary playback speeds,
+    // all channels are read by the same head so it advances only once for the block
+
+    _playbackReadIndex = recordBuffer->read( _playbackReadIndex, _playbackRate, outputs, bufferSize, _driftInterpolation );
+
+    if ( _driftMix == 1.f && driftTarget == 1.f ) {
+        return; // fully drifting, nothing to mix in
+    }
+
+    float driftMix = _driftMix;
+
+    for ( int32 c = 0; c < Channels; ++c )
+    {
+        const float* input = inputs[ c ];
+        float* output      = outputs[ c ];
+
+        driftMix = _driftMix;
+
+        for ( int i = 0; i < bufferSize; ++i ) {
+            output[ i ] = input[ i ] + ( output[ i ] - input[ i ] ) * driftMix;
+
+            if ( driftMix != driftTarget ) {
+                driftMix = ( driftMix < driftTarget ) ? std::min( driftTarget, driftMix + _driftFadeStep )
+                                                      : std::max( driftTarget, driftMix - _driftFadeStep );
+            }
+        }
+    }
+    _driftMix = driftMix;
+}
+
+template <int Channels, int Combs, int AllPasses>
+float ReverbEngine<Channels, Combs, AllPasses>::getPeak( float** buffers, int bufferSize )
+{
+    float peak = 0.f;
+
+    for ( int c = 0; c < Channels; ++c ) {
+        float* buffer = buffers[ c ];
+        for ( int i = 0; i < bufferSize; ++i ) {
+            peak = std::max( peak, std::fabs( buffer[ i ] ));
+        }
+    }
+    return peak;
+}
+
+template <int Channels, int Combs, int AllPasses>
+void ReverbEngine<Channels, Combs, AllPasses>::allocateMemory()
+{
+    // calculate the size of the arena holding the delay lines of all channels, the mix buffers,
+    // the filter state and the modulation buffers
+
+    size_t arenaSize = getMixBufferSize() * 2 + Filter::getMemorySize( Channels ) + ModulationBus::getMemorySize( _maxBufferSize );
+
+    for ( int c = 0; c < Channels; ++c ) {
+        for ( int i = 0; i < Combs; ++i ) {
+            arenaSize += Arena::align( getDelaySize( VST::COMB_TUNINGS[ i ], c ) * sizeof( float ));
+        }
+        for ( int i = 0; i < AllPasses; ++i ) {
+            arenaSize += Arena::align( getDelaySize( VST::ALLPASS_TUNINGS[ i ], c ) * sizeof( float ));
+        }
+    }
+    _arena.allocate( arenaSize );
+
+    _preMix  = takeMixBuffer();
+    _postMix = takeMixBuffer();
+
+    _filter.setMemory( _arena.take<float>( Filter::getMemorySize( Channels ) / sizeof( float )), Channels );
+    _modulation.setMemory( _arena.take<float>( ModulationBus::getMemorySize( _maxBufferSize ) / sizeof( float )), _maxBufferSize );
+
+    // create buffers per output channel
+
+    for ( int c = 0; c < Channels; ++c ) {
+
+        // comb filters
+
+        for ( int i = 0; i < Combs; ++i ) {
+            int size = getDelaySize( VST::COMB_TUNINGS[ i ], c );
+            _combs.setBuffer( c, i, _arena.take<float>( size ), size );
+        }
+
+        // all pass filters
+
+        for ( int i = 0; i < AllPasses; ++i ) {
+            int size = getDelaySize( VST::ALLPASS_TUNINGS[ i ], c );
+            _allpasses.setBuffer( c, i, _arena.take<float>( size ), size );
+        }
+    }
+}
+
+}
@@ -21,243 +21,156 @@
  * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
 #include "reverbprocess.h"
-#include "calc.h"
-#include <math.h>
 
 namespace Igorski {
 
-ReverbProcess::ReverbProcess( int amountOfChannels, float sampleRate ) {
-    _sampleRate = sampleRate;
-
-    // jpc: resolve use of uninitialized memory
-    _mode = INITIAL_MODE;
-
-    _amountOfChannels = amountOfChannels;
-
-    _maxRecordIndex = Calc::millisecondsToBuffer( MAX_RECORD_TIME_MS, sampleRate );
-    _recordBuffer   = new AudioBuffer( amountOfChannels, _maxRecordIndex );
-    _recordIndices  = new int[ amountOfChannels ];
-    for ( int i = 0; i < amountOfChannels; ++i ) {
-        _recordIndices[ i ] = 0;
+ReverbProcess::ReverbProcess( int amountOfChannels, float sampleRate, int maxBufferSize ) {
+
+    // create the engine specialized for the amount of channels, hosts
+    // with an unusual layout use the widest engine (unused channels remain silent)
+
+    switch ( amountOfChannels ) {
+        case 1:
+            _engine = new ReverbEngine<1>( sampleRate, maxBufferSize );
+            break;
+        case 2:
+            _engine = new ReverbEngine<2>( sampleRate, maxBufferSize );
+            break;
+        default:
+            _engine = new ReverbEngine<VST::MAX_CHANNELS>( sampleRate, maxBufferSize );
+            break;
     }
-    _playbackReadIndex = 0.f;
-
-    bitCrusher = new BitCrusher( 8, .5f, .5f, sampleRate );
-    decimator  = new Decimator( 32, 0.f );
-    filter     = new Filter( sampleRate );
-    limiter    = new Limiter( 10.f, 500.f, .6f );
 
-    setupFilters();
+    bitCrusher = _engine->bitCrusher;
+    decimator  = _engine->decimator;
+    filter     = _engine->filter;
+    limiter    = _engine->limiter;
 
-    setWet     ( INITIAL_WET );
-    setRoomSize( INITIAL_ROOM );
-    setDry     ( INITIAL_DRY );
-    setDamp    ( INITIAL_DAMP );
-    setWidth   ( INITIAL_WIDTH );
-    setMode    ( INITIAL_MODE );
-
-    // this will initialize the buffers with silence
-    mute();
-
-    // will be lazily created in the process function
-    _preMixBuffer  = nullptr;
-    _postMixBuffer = nullptr;
-    _playbackRate  = 1.f;
+    bitCrusherPostMix = _engine->bitCrusherPostMix;
 }
 
 ReverbProcess::~ReverbProcess() {
-    delete[] _recordIndices;
-    delete _recordBuffer;
-    delete _postMixBuffer;
-    delete _preMixBuffer;
-    delete bitCrusher;
-    delete decimator;
-    delete filter;
-    delete limiter;
-    clearFilters();
+    delete _engine;
 }
 
 void ReverbProcess::mute()
 {
-    if ( getMode() >= FREEZE_MODE )
-        return;
-
-    for ( int c = 0; c < _amountOfChannels; ++c ) {
-        auto combData = _combFilters.at( c );
-        for ( int i = 0; i < VST::NUM_COMBS; i++ ) {
-            combData->filters.at( i )->mute();
-        }
-
-        auto allPassData = _allpassFilters.at( c );
-        for ( int i = 0; i < VST::NUM_ALLPASSES; i++ ) {
-            allPassData->filters.at( i )->mute();
-        }
-    }
+    _engine->mute();
 }
 
-float ReverbProcess::getRoomSize()
+void ReverbProcess::setMaxBufferSize( int maxBufferSize )
 {
-    return ( _roomSize - OFFSET_ROOM ) / SCALE_ROOM;
+    _engine->setMaxBufferSize( maxBufferSize );
 }
 
-void ReverbProcess::setRoomSize( float value )
+bool ReverbProcess::wantsRecordBuffer()
 {
-    _roomSize = ( value * SCALE_ROOM ) + OFFSET_ROOM;
-    update();
+    return _engine->wantsRecordBuffer();
 }
 
-float ReverbProcess::getDamp()
+void ReverbProcess::createRecordBuffer()
 {
-    return _damp / SCALE_DAMP;
+    _engine->createRecordBuffer();
 }
 
-void ReverbProcess::setDamp( float value )
+void ReverbProcess::setRecordFormat( RecordBuffer::Format format )
 {
-    _damp = value * SCALE_DAMP;
-    update();
+    _engine->setRecordFormat( format );
 }
 
-float ReverbProcess::getWet()
+void ReverbProcess::setDriftInterpolation( RecordBuffer::Interpolation interpolation )
 {
-    return _wet / SCALE_WET;
+    _engine->setDriftInterpolation( interpolation );
 }
 
-void ReverbProcess::setWet( float value )
+void ReverbProcess::setRecordTime( float milliseconds )
 {
-    _wet = value * SCALE_WET;
-    update();
+    _engine->setRecordTime( milliseconds );
 }
 
-float ReverbProcess::getDry()
+float ReverbProcess::getRecordTime()
 {
-    return _dry / SCALE_DRY;
+    return _engine->getRecordTime();
 }
 
-void ReverbProcess::setDry( float value )
+void ReverbProcess::setMemoryBudget( size_t bytes )
 {
-    _dry = value * SCALE_DRY;
+    _engine->setMemoryBudget( bytes );
 }
 
-float ReverbProcess::getWidth()
+size_t ReverbProcess::getMemoryFootprint()
 {
-    return _width;
+    return _engine->getMemoryFootprint();
 }
 
-void ReverbProcess::setWidth( float value )
+float ReverbProcess::getRoomSize()
 {
-    _width = value;
-    update();
+    return _engine->getRoomSize();
 }
 
-float ReverbProcess::getPlaybackRate()
+void ReverbProcess::setRoomSize( float value )
 {
-    return Calc::scale( _playbackRate - MIN_PLAYBACK_RATE, 1.0f, 1.0f );
+    _engine->setRoomSize( value );
 }
 
-void ReverbProcess::setPlaybackRate( float value )
+float ReverbProcess::getDamp()
 {
-    // "snap" to neutral setting when roughly halfway
-    if ( value >= .48f && value <= .52f ) {
-        _playbackRate = 1.0f;
-    }
-     else {
-        _playbackRate = MIN_PLAYBACK_RATE + Calc::scale(value, 1.0f, 1.0f );
-    }
+    return _engine->getDamp();
 }
 
-float ReverbProcess::getMode()
+void ReverbProcess::setDamp( float value )
 {
-    return ( _mode >= FREEZE_MODE ) ? 1 : 0;
+    _engine->setDamp( value );
 }
 
-void ReverbProcess::setMode( float value )
+float ReverbProcess::getWet()
 {
-    _mode = value;
-    update();
+    return _engine->getWet();
 }
 
-void ReverbProcess::setupFilters()
+void ReverbProcess::setWet( float value )
 {
-    clearFilters();
-
-    // create filters and buffers per output channel
-
-    float sampleRate = _sampleRate;
-
-    for ( int c = 0; c < _amountOfChannels; ++c ) {
-        combFilters* combData = new combFilters();
-        _combFilters.push_back( combData );
-
-        // comb filters
-
-        for ( int i = 0; i < VST::NUM_COMBS; ++i ) {
-            // tune the comb to the host environments sample rate
-            int tuning = ( int ) ((( float ) VST::COMB_TUNINGS[ i ] / 44100.f ) * sampleRate );
-            int size = tuning + ( c * STEREO_SPREAD );
-            float* buffer = new float[ size ];
-
-            Comb* comb = new Comb();
-            comb->setBuffer( buffer, size );
-            combData->filters.push_back( comb );
-            combData->buffers.push_back( buffer );
-        }
-
-        // all pass filters
+    _engine->setWet( value );
+}
 
-        allpassFilters* allpassData = new allpassFilters();
-        _allpassFilters.push_back( allpassData );
+float ReverbProcess::getDry()
+{
+    return _engine->getDry();
+}
 
-        for ( int i = 0; i < VST::NUM_ALLPASSES; ++i ) {
-            // tune the comb to the host environments sample rate
-            int tuning = ( int ) ((( float ) VST::ALLPASS_TUNINGS[ i ] / 44100.f ) * sampleRate );
-            int size = tuning + ( c * STEREO_SPREAD );
-            float* buffer = new float[ size ];
+void ReverbProcess::setDry( float value )
+{
+    _engine->setDry( value );
+}
 
-            AllPass* allPass = new AllPass();
-            allPass->setBuffer( buffer, size );
-            allpassData->filters.push_back( allPass );
-            allpassData->buffers.push_back( buffer );
-        }
-    }
+float ReverbProcess::getWidth()
+{
+    return _engine->getWidth();
 }
 
-void ReverbProcess::clearFilters()
+void ReverbProcess::setWidth( float value )
 {
-    while ( !_combFilters.empty() ) {
-        delete _combFilters.at( 0 );
-        _combFilters.erase( _combFilters.begin() );
-    }
-    while ( !_allpassFilters.empty() ) {
-        delete _allpassFilters.at( 0 );
-        _allpassFilters.erase( _allpassFilters.begin() );
-    }
+    _engine->setWidth( value );
 }
 
-void ReverbProcess::update()
+float ReverbProcess::getMode()
 {
-    // Recalculate internal values after parameter change
+    return _engine->getMode();
+}
 
-    _wet1 = _wet * ( _width / 2 + 0.5f );
-    _wet2 = _wet * (( 1 - _width ) / 2 );
+void ReverbProcess::setMode( float value )
+{
+    _engine->setMode( value );
+}
 
-    if ( _mode >= FREEZE_MODE ){
-        _roomSize1 = 1;
-        _damp1     = 0;
-        _gain      = MUTED;
-    }
-    else {
-        _roomSize1 = _roomSize;
-        _damp1     = _damp;
-        _gain      = FIXED_GAIN;
-    }
+float ReverbProcess::getPlaybackRate()
+{
+    return _engine->getPlaybackRate();
+}
 
-    for ( int c = 0; c < _amountOfChannels; ++c ) {
-        auto combData = _combFilters.at( c );
-        for ( int i = 0; i < VST::NUM_COMBS; i++ ) {
-            combData->filters.at( i )->setFeedback( _roomSize1 );
-            combData->filters.at( i )->setDamp( _damp1 );
-        }
-    }
+void ReverbProcess::setPlaybackRate( float value )
+{
+    _engine->setPlaybackRate( value );
 }
 
 }
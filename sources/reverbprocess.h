@@ -24,74 +24,20 @@
 #define __REVERBPROCESS__H_INCLUDED__
 
 #include "global.h"
-#include "audiobuffer.h"
-#include "comb.h"
-#include "allpass.h"
-#include "bitcrusher.h"
-#include "decimator.h"
-#include "filter.h"
-#include "limiter.h"
-#include <vector>
+#include "reverbengine.h"
 
 namespace Igorski {
+/**
+ * ReverbProcess is the runtime facade of the reverb. It creates the ReverbEngine
+ * specialized for the requested amount of channels (falling back onto the widest
+ * engine for unusual layouts) and forwards all processing and parameters onto it
+ */
 class ReverbProcess {
 
-    struct combFilters {
-        std::vector<Comb*> filters;
-        std::vector<float*> buffers;
-
-        ~combFilters() {
-            while ( !filters.empty() ) {
-                delete filters.at( 0 );
-                filters.erase( filters.begin() );
-            }
-            while ( !buffers.empty() ) {
-                delete[] buffers.at( 0 );
-                buffers.erase( buffers.begin() );
-            }
-        }
-    };
-
-    struct allpassFilters {
-        std::vector<AllPass*> filters;
-        std::vector<float*> buffers;
-
-        ~allpassFilters() {
-            while ( !filters.empty() ) {
-                delete filters.at( 0 );
-                filters.erase( filters.begin() );
-            }
-            while ( !buffers.empty() ) {
-                delete[] buffers.at( 0 );
-                buffers.erase( buffers.begin() );
-            }
-        }
-    };
-
-    static constexpr float MAX_RECORD_TIME_MS = 5000.f;
-    static constexpr float MUTED              = 0;
-    static constexpr float FIXED_GAIN         = 0.015f;
-    static constexpr float SCALE_WET          = 1.f;
-    static constexpr float SCALE_DRY          = 1.f;
-    static constexpr float SCALE_DAMP         = 0.4f;
-    static constexpr float SCALE_ROOM         = 0.28f;
-    static constexpr float OFFSET_ROOM        = 0.7f;
-    static constexpr float INITIAL_ROOM       = 0.5f;
-    static constexpr float INITIAL_DAMP       = 0.5f;
-    static constexpr float INITIAL_WET        = 1 / SCALE_WET;
-    static constexpr float INITIAL_DRY        = 0.5;
-    static constexpr float INITIAL_WIDTH      = 1;
-    static constexpr float INITIAL_MODE       = 0;
-    static constexpr float FREEZE_MODE        = 0.5f;
-    static constexpr int STEREO_SPREAD        = 23;
-
-    // we allow only a slowdown and speed up of 100 pct
-
-    static constexpr float MIN_PLAYBACK_RATE = 0.5f;
-    static constexpr float MAX_PLAYBACK_RATE = 1.5f;
-
     public:
-        ReverbProcess( int amountOfChannels, float sampleRate );
+        // maxBufferSize is the largest block the host will provide (see setMaxBufferSize())
+
+        ReverbProcess( int amountOfChannels, float sampleRate, int maxBufferSize );
         ~ReverbProcess();
 
         // apply effect to incoming sampleBuffer contents
@@ -102,6 +48,26 @@ class ReverbProcess {
         );
 
         void mute();
+
+        // to be called (outside of the process cycle) when the largest
+        // block size the host will provide has changed, see ReverbEngineBase
+
+        void setMaxBufferSize( int maxBufferSize );
+
+        // the drift record buffer is allocated on demand (see ReverbEngineBase)
+
+        bool wantsRecordBuffer();
+        void createRecordBuffer();
+        void setRecordFormat( RecordBuffer::Format format );
+        void setDriftInterpolation( RecordBuffer::Interpolation interpolation );
+
+        // drift history length and memory budget (see ReverbEngineBase)
+
+        void setRecordTime( float milliseconds );
+        float getRecordTime();
+        void setMemoryBudget( size_t bytes );
+        size_t getMemoryFootprint();
+
         void setRoomSize( float value );
         float getRoomSize();
         void setDamp( float value );
@@ -117,6 +83,8 @@ class ReverbProcess {
         float getPlaybackRate();
         void setPlaybackRate( float value );
 
+        // the effects are owned by the engine
+
         BitCrusher* bitCrusher;
         Decimator* decimator;
         Filter* filter;
@@ -128,40 +96,7 @@ class ReverbProcess {
         bool bitCrusherPostMix;
 
     private:
-        AudioBuffer* _recordBuffer;  // contains the sample memory for drift mode
-        AudioBuffer* _preMixBuffer;  // buffer used for the pre-delay effect mixing
-        AudioBuffer* _postMixBuffer; // buffer used for the post-delay effect mixing
-        int  _amountOfChannels;
-        int  _maxRecordIndex;
-        int* _recordIndices;
-
-        void setupFilters();         // generates comb and allpass filter buffers
-        void clearFilters();         // frees memory allocated to comb and allpass filter buffers
-        void update();
-
-        float _playbackRate;
-        float _playbackReadIndex;
-
-        float _gain;
-        float _roomSize, _roomSize1;
-        float _damp, _damp1;
-        float _wet, _wet1, _wet2;
-        float _dry;
-        float _width;
-        float _mode;
-
-        std::vector<combFilters*>    _combFilters;
-        std::vector<allpassFilters*> _allpassFilters;
-
-        float _sampleRate;
-
-        // ensures the pre- and post mix buffers match the appropriate amount of channels
-        // and buffer size. this also clones the contents of given in buffer into the pre-mix buffer
-        // the buffers are pooled so this can be called upon each process cycle without allocation overhead
-
-        template <typename SampleType>
-        void prepareMixBuffers( SampleType** inBuffer, int numInChannels, int bufferSize );
-
+        ReverbEngineBase* _engine;
 };
 }
 
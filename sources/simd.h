@@ -0,0 +1,178 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#ifndef __SIMD_H_INCLUDED__
+#define __SIMD_H_INCLUDED__
+
+/**
+ * minimal abstraction over the vector instruction set available at compile time
+ * kernels are written against SIMD::vfloat and step through their data in
+ * increments of SIMD::WIDTH, all loads and stores are unaligned. SIMD::vint
+ * holds the same amount of 32-bit integers (for bit masks), toInt() truncates.
+ * blend() selects b in the lanes where all bits of the mask are set (else a),
+ * floor() is limited to values within the 32-bit integer range
+ */
+#if defined(__AVX__)
+#   include <immintrin.h>
+#   define FOGPAD_SIMD_AVX 1
+#elif defined(__SSE2__) || defined(_M_X64) || ( defined(_M_IX86_FP) && _M_IX86_FP >= 2 )
+#   include <emmintrin.h>
+#   define FOGPAD_SIMD_SSE 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#   include <arm_neon.h>
+#   define FOGPAD_SIMD_NEON 1
+#else
+#   include <math.h>
+#endif
+
+namespace Igorski {
+namespace SIMD {
+
+#if defined(FOGPAD_SIMD_AVX)
+
+    typedef __m256  vfloat;
+    typedef __m256i vint;
+    static const int WIDTH = 8;
+
+    inline vfloat load( const float* p )          { return _mm256_loadu_ps( p ); }
+    inline void   store( float* p, vfloat v )     { _mm256_storeu_ps( p, v ); }
+    inline vfloat set1( float value )             { return _mm256_set1_ps( value ); }
+    inline vfloat add( vfloat a, vfloat b )       { return _mm256_add_ps( a, b ); }
+    inline vfloat sub( vfloat a, vfloat b )       { return _mm256_sub_ps( a, b ); }
+    inline vfloat mul( vfloat a, vfloat b )       { return _mm256_mul_ps( a, b ); }
+    inline vfloat min( vfloat a, vfloat b )       { return _mm256_min_ps( a, b ); }
+    inline vfloat max( vfloat a, vfloat b )       { return _mm256_max_ps( a, b ); }
+
+    // AVX has no 256-bit integer logic, the mask is applied in the float domain
+
+    inline vint   set1Int( int value )            { return _mm256_set1_epi32( value ); }
+    inline vint   toInt( vfloat v )               { return _mm256_cvttps_epi32( v ); }
+    inline vfloat toFloat( vint v )               { return _mm256_cvtepi32_ps( v ); }
+    inline vint   bitAnd( vint a, vint b )
+    {
+        return _mm256_castps_si256( _mm256_and_ps( _mm256_castsi256_ps( a ), _mm256_castsi256_ps( b )));
+    }
+    inline vint   loadInt( const int* p )         { return _mm256_loadu_si256(( const __m256i* ) p ); }
+    inline vfloat floor( vfloat v )               { return _mm256_floor_ps( v ); }
+    inline vfloat blend( vint mask, vfloat a, vfloat b ) { return _mm256_blendv_ps( a, b, _mm256_castsi256_ps( mask )); }
+
+#elif defined(FOGPAD_SIMD_SSE)
+
+    typedef __m128  vfloat;
+    typedef __m128i vint;
+    static const int WIDTH = 4;
+
+    inline vfloat load( const float* p )          { return _mm_loadu_ps( p ); }
+    inline void   store( float* p, vfloat v )     { _mm_storeu_ps( p, v ); }
+    inline vfloat set1( float value )             { return _mm_set1_ps( value ); }
+    inline vfloat add( vfloat a, vfloat b )       { return _mm_add_ps( a, b ); }
+    inline vfloat sub( vfloat a, vfloat b )       { return _mm_sub_ps( a, b ); }
+    inline vfloat mul( vfloat a, vfloat b )       { return _mm_mul_ps( a, b ); }
+    inline vfloat min( vfloat a, vfloat b )       { return _mm_min_ps( a, b ); }
+    inline vfloat max( vfloat a, vfloat b )       { return _mm_max_ps( a, b ); }
+
+    inline vint   set1Int( int value )            { return _mm_set1_epi32( value ); }
+    inline vint   toInt( vfloat v )               { return _mm_cvttps_epi32( v ); }
+    inline vfloat toFloat( vint v )               { return _mm_cvtepi32_ps( v ); }
+    inline vint   bitAnd( vint a, vint b )        { return _mm_and_si128( a, b ); }
+    inline vint   loadInt( const int* p )         { return _mm_loadu_si128(( const __m128i* ) p ); }
+
+    inline vfloat floor( vfloat v )
+    {
+        // truncate and step down where that rounded a negative value up
+        __m128 t = _mm_cvtepi32_ps( _mm_cvttps_epi32( v ));
+        return _mm_sub_ps( t, _mm_and_ps( _mm_cmpgt_ps( t, v ), _mm_set1_ps( 1.f )));
+    }
+
+    inline vfloat blend( vint mask, vfloat a, vfloat b )
+    {
+        __m128 m = _mm_castsi128_ps( mask );
+        return _mm_or_ps( _mm_and_ps( m, b ), _mm_andnot_ps( m, a ));
+    }
+
+#elif defined(FOGPAD_SIMD_NEON)
+
+    typedef float32x4_t vfloat;
+    typedef int32x4_t   vint;
+    static const int WIDTH = 4;
+
+    inline vfloat load( const float* p )          { return vld1q_f32( p ); }
+    inline void   store( float* p, vfloat v )     { vst1q_f32( p, v ); }
+    inline vfloat set1( float value )             { return vdupq_n_f32( value ); }
+    inline vfloat add( vfloat a, vfloat b )       { return vaddq_f32( a, b ); }
+    inline vfloat sub( vfloat a, vfloat b )       { return vsubq_f32( a, b ); }
+    inline vfloat mul( vfloat a, vfloat b )       { return vmulq_f32( a, b ); }
+    inline vfloat min( vfloat a, vfloat b )       { return vminq_f32( a, b ); }
+    inline vfloat max( vfloat a, vfloat b )       { return vmaxq_f32( a, b ); }
+
+    inline vint   set1Int( int value )            { return vdupq_n_s32( value ); }
+    inline vint   toInt( vfloat v )               { return vcvtq_s32_f32( v ); }
+    inline vfloat toFloat( vint v )               { return vcvtq_f32_s32( v ); }
+    inline vint   bitAnd( vint a, vint b )        { return vandq_s32( a, b ); }
+    inline vint   loadInt( const int* p )         { return vld1q_s32( p ); }
+
+    inline vfloat floor( vfloat v )
+    {
+        // truncate and step down where that rounded a negative value up
+        float32x4_t t = vcvtq_f32_s32( vcvtq_s32_f32( v ));
+        uint32x4_t up = vandq_u32( vcgtq_f32( t, v ), vreinterpretq_u32_f32( vdupq_n_f32( 1.f )));
+        return vsubq_f32( t, vreinterpretq_f32_u32( up ));
+    }
+
+    inline vfloat blend( vint mask, vfloat a, vfloat b ) { return vbslq_f32( vreinterpretq_u32_s32( mask ), b, a ); }
+
+#else
+
+    // no vector unit available, kernels degrade to plain scalar loops
+
+    typedef float vfloat;
+    typedef int   vint;
+    static const int WIDTH = 1;
+
+    inline vfloat load( const float* p )          { return *p; }
+    inline void   store( float* p, vfloat v )     { *p = v; }
+    inline vfloat set1( float value )             { return value; }
+    inline vfloat add( vfloat a, vfloat b )       { return a + b; }
+    inline vfloat sub( vfloat a, vfloat b )       { return a - b; }
+    inline vfloat mul( vfloat a, vfloat b )       { return a * b; }
+    inline vfloat min( vfloat a, vfloat b )       { return a < b ? a : b; }
+    inline vfloat max( vfloat a, vfloat b )       { return a > b ? a : b; }
+    inline vint   set1Int( int value )            { return value; }
+    inline vint   toInt( vfloat v )               { return ( int ) v; }
+    inline vfloat toFloat( vint v )               { return ( float ) v; }
+    inline vint   bitAnd( vint a, vint b )        { return a & b; }
+    inline vint   loadInt( const int* p )         { return *p; }
+    inline vfloat floor( vfloat v )               { return ::floorf( v ); }
+    inline vfloat blend( vint mask, vfloat a, vfloat b ) { return mask ? b : a; }
+
+#endif
+
+    // a * b + c
+
+    inline vfloat madd( vfloat a, vfloat b, vfloat c )
+    {
+        return add( mul( a, b ), c );
+    }
+}
+}
+
+#endif
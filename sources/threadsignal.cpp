@@ -0,0 +1,114 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "threadsignal.h"
+
+#if defined(_WIN32)
+#   define WIN32_LEAN_AND_MEAN
+#   define NOMINMAX
+#   include <windows.h>
+#   include <limits.h>
+#elif defined(__APPLE__)
+#   include <dispatch/dispatch.h>
+#else
+#   include <semaphore.h>
+#   include <errno.h>
+#endif
+
+namespace Igorski {
+
+#if defined(_WIN32)
+
+ThreadSignal::ThreadSignal()
+{
+    _handle = CreateSemaphore( nullptr, 0, LONG_MAX, nullptr );
+}
+
+ThreadSignal::~ThreadSignal()
+{
+    CloseHandle( _handle );
+}
+
+void ThreadSignal::post()
+{
+    ReleaseSemaphore( _handle, 1, nullptr );
+}
+
+void ThreadSignal::wait()
+{
+    WaitForSingleObject( _handle, INFINITE );
+}
+
+#elif defined(__APPLE__)
+
+// unnamed POSIX semaphores are not supported on macOS, use those of libdispatch
+
+ThreadSignal::ThreadSignal()
+{
+    _handle = dispatch_semaphore_create( 0 );
+}
+
+ThreadSignal::~ThreadSignal()
+{
+    dispatch_release( static_cast<dispatch_semaphore_t>( _handle ));
+}
+
+void ThreadSignal::post()
+{
+    dispatch_semaphore_signal( static_cast<dispatch_semaphore_t>( _handle ));
+}
+
+void ThreadSignal::wait()
+{
+    dispatch_semaphore_wait( static_cast<dispatch_semaphore_t>( _handle ), DISPATCH_TIME_FOREVER );
+}
+
+#else
+
+ThreadSignal::ThreadSignal()
+{
+    sem_t* semaphore = new sem_t;
+    sem_init( semaphore, 0, 0 );
+    _handle = semaphore;
+}
+
+ThreadSignal::~ThreadSignal()
+{
+    sem_t* semaphore = static_cast<sem_t*>( _handle );
+    sem_destroy( semaphore );
+    delete semaphore;
+}
+
+void ThreadSignal::post()
+{
+    sem_post( static_cast<sem_t*>( _handle ));
+}
+
+void ThreadSignal::wait()
+{
+    // retry when interrupted by a signal
+    while ( sem_wait( static_cast<sem_t*>( _handle )) != 0 && errno == EINTR ) {}
+}
+
+#endif
+
+}
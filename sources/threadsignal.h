@@ -1,7 +1,7 @@
 /**
  * The MIT License (MIT)
  *
- * Based on freeverb by Jezar at Dreampoint (June 2000)
+ * Copyright (c) 2019 Igor Zinken - https://www.igorski.nl
  *
  * Permission is hereby granted, free of charge, to any person obtaining a copy of
  * this software and associated documentation files (the "Software"), to deal in
@@ -20,37 +20,31 @@
  * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
  * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
  */
- #include "allpass.h"
+#ifndef __THREADSIGNAL_H_INCLUDED__
+#define __THREADSIGNAL_H_INCLUDED__
 
- namespace Igorski {
-
- AllPass::AllPass()
- {
-     _bufIndex = 0;
-     setFeedback( 0.5f );
- }
-
- void AllPass::setBuffer( float *buf, int size )
- {
-     _buffer  = buf;
-     _bufSize = size;
- }
+namespace Igorski {
+/**
+ * ThreadSignal (a semaphore) lets a thread sleep until it is signalled by
+ * another. Signalling (post()) does not lock nor allocate, as such the audio
+ * thread can use it to wake up a worker thread
+ */
+class ThreadSignal
+{
+    public:
+        ThreadSignal();
+        ~ThreadSignal();
 
- void AllPass::mute()
- {
-     for ( int i = 0; i < _bufSize; i++ ) {
-         _buffer[ i ] = 0;
-     }
- }
+        void post();
+        void wait();
 
- float AllPass::getFeedback()
- {
-     return _feedback;
- }
+    private:
+        ThreadSignal( const ThreadSignal& );
+        ThreadSignal& operator=( const ThreadSignal& );
 
- void AllPass::setFeedback( float val )
- {
-     _feedback = val;
- }
+        // the platform semaphore (see threadsignal.cpp)
+        void* _handle;
+};
+}
 
- }
+#endif
@@ -0,0 +1,129 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "combbank.h"
+#include "allpasschain.h"
+#include "denormalguard.h"
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+using namespace Igorski;
+
+// feeds a burst of noise into the comb filters and all pass filters of the reverb and lets the tail
+// decay over a long period of silence, with and without flushing denormals to zero. Reports the
+// average time taken per block for the first and the last part of the tail, without flushing the
+// latter is where the feedback loops have decayed into the denormal range
+
+// the reverb network is driven directly as the engine stops processing once its output is silent
+// (see ReverbEngine::_sleeping), which hides the cost of denormals rather than showing it
+
+static const float SAMPLE_RATE = 44100.f;
+static const int   CHANNELS    = 2;
+static const int   BLOCK_SIZE  = 128;
+static const int   SECONDS     = 60;
+static const float FEEDBACK    = .84f; // the room size and damping the engine starts with
+static const float DAMP        = .2f;
+
+// averages in µs per block for the first and the last second of the tail
+
+struct Result {
+    double first;
+    double last;
+};
+
+static void process( CombBank<CHANNELS>& combs, AllPassChain<CHANNELS>& allpasses, float** buffers )
+{
+    combs.processBlock( buffers, buffers, BLOCK_SIZE );
+    allpasses.processBlock( buffers, buffers, BLOCK_SIZE );
+}
+
+static Result render( bool flushDenormals )
+{
+    CombBank<CHANNELS> combs;
+    AllPassChain<CHANNELS> allpasses;
+    std::vector<std::vector<float>> delays;
+
+    for ( int c = 0; c < CHANNELS; ++c ) {
+        for ( int i = 0; i < VST::NUM_COMBS; ++i ) {
+            delays.emplace_back( VST::COMB_TUNINGS[ i ] + c * 23, 0.f ); // 23 being the engine's stereo spread
+            combs.setBuffer( c, i, delays.back().data(), ( int ) delays.back().size() );
+        }
+        for ( int i = 0; i < VST::NUM_ALLPASSES; ++i ) {
+            delays.emplace_back( VST::ALLPASS_TUNINGS[ i ] + c * 23, 0.f );
+            allpasses.setBuffer( c, i, delays.back().data(), ( int ) delays.back().size() );
+        }
+    }
+    combs.setFeedback( FEEDBACK );
+    combs.setDamp( DAMP );
+    allpasses.setFeedback( .5f );
+
+    float left[ BLOCK_SIZE ], right[ BLOCK_SIZE ];
+    float* buffers[ CHANNELS ] = { left, right };
+
+    const int blocks          = ( int ) SAMPLE_RATE * SECONDS / BLOCK_SIZE;
+    const int blocksPerSecond = ( int ) SAMPLE_RATE / BLOCK_SIZE;
+    double first = 0.0, last = 0.0;
+    unsigned int seed = 1;
+
+    for ( int block = 0; block < blocks; ++block ) {
+        for ( int i = 0; i < BLOCK_SIZE; ++i ) {
+            float noise = 0.f;
+            if ( block == 0 ) {
+                seed  = seed * 1664525u + 1013904223u;
+                noise = (( float )( seed >> 8 ) / 16777216.f - .5f ) * .015f; // at the engine's fixed gain
+            }
+            left[ i ] = right[ i ] = noise;
+        }
+        auto start = std::chrono::steady_clock::now();
+        if ( flushDenormals ) {
+            DenormalGuard guard; // as created by the plugin for each block
+            process( combs, allpasses, buffers );
+        }
+        else {
+            process( combs, allpasses, buffers );
+        }
+        double elapsed = std::chrono::duration<double, std::micro>( std::chrono::steady_clock::now() - start ).count();
+
+        if ( block < blocksPerSecond )
+            first += elapsed;
+        else if ( block >= blocks - blocksPerSecond )
+            last += elapsed;
+    }
+    return { first / blocksPerSecond, last / blocksPerSecond };
+}
+
+int main()
+{
+    Result unguarded = render( false );
+    Result guarded   = render( true );
+
+    printf( "decaying tail of %d s, %d samples per block\n", SECONDS, BLOCK_SIZE );
+    printf( "without flushing denormals: %6.2f us per block at the start, %6.2f us per block at the end\n",
+            unguarded.first, unguarded.last );
+    printf( "flushing denormals:         %6.2f us per block at the start, %6.2f us per block at the end\n",
+            guarded.first, guarded.last );
+    printf( "cost at the end of the tail is %.1fx lower when flushing denormals\n", unguarded.last / guarded.last );
+
+    return EXIT_SUCCESS;
+}
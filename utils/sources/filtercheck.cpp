@@ -0,0 +1,110 @@
+/**
+ * The MIT License (MIT)
+ *
+ * Copyright (c) 2019 Igor Zinken - https://www.igorski.nl
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy of
+ * this software and associated documentation files (the "Software"), to deal in
+ * the Software without restriction, including without limitation the rights to
+ * use, copy, modify, merge, publish, distribute, sublicense, and/or sell copies of
+ * the Software, and to permit persons to whom the Software is furnished to do so,
+ * subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY, FITNESS
+ * FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE AUTHORS OR
+ * COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER LIABILITY, WHETHER
+ * IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM, OUT OF OR IN
+ * CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE SOFTWARE.
+ */
+#include "filter.h"
+#include "arena.h"
+#include <chrono>
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+
+using namespace Igorski;
+
+// renders a sweep of the filter LFO over noise with the coefficients calculated for every
+// sample and at the filter's default control rate, for both topologies at low, medium and high
+// resonance. Reports the time taken by each and fails when the largest deviation between both
+// exceeds the threshold (relative to the output peak)
+
+static const float SAMPLE_RATE      = 44100.f;
+static const int   CHANNELS         = 2;
+static const int   BLOCK_SIZE       = 128;
+static const int   SECONDS          = 10;
+static const float MAX_DEVIATION_DB = -50.f;
+
+// renders given input through a filter at given topology and control rate, returns the time in ms
+
+static double render( std::vector<float>& samples, int frames, Filter::Topology topology, float resonance, int controlRate )
+{
+    Filter filter( SAMPLE_RATE );
+    filter.setTopology( topology );
+    filter.setControlRate( controlRate );
+    filter.updateProperties( .5f, resonance, 1.f, 1.f ); // fastest LFO at full depth
+
+    Arena arena;
+    arena.allocate( Filter::getMemorySize( CHANNELS ));
+    filter.setMemory( arena.take<float>( Filter::getMemorySize( CHANNELS ) / sizeof( float )), CHANNELS );
+
+    AudioBufferView buffer = { samples.data(), CHANNELS, BLOCK_SIZE, ( size_t ) frames };
+    float modulation[ BLOCK_SIZE ];
+
+    auto start = std::chrono::steady_clock::now();
+
+    for ( int offset = 0; offset < frames; offset += BLOCK_SIZE ) {
+        filter.lfo.fill( modulation, BLOCK_SIZE );
+        filter.process( buffer.slice( offset, BLOCK_SIZE ), modulation );
+    }
+    return std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+}
+
+int main()
+{
+    const int frames = ( int ) SAMPLE_RATE * SECONDS / BLOCK_SIZE * BLOCK_SIZE;
+
+    std::vector<float> noise( frames * CHANNELS );
+    unsigned int seed = 1;
+    for ( size_t i = 0; i < noise.size(); ++i ) {
+        seed = seed * 1664525u + 1013904223u;
+        noise[ i ] = ( float )( seed >> 8 ) / 16777216.f - .5f;
+    }
+
+    const char* names[]    = { "biquad", "svf" };
+    const float resonances[] = { 0.f, .5f, 1.f }; // in normalized range (0 being the highest Q)
+
+    int controlRate = Filter::DEFAULT_CONTROL_RATE;
+    bool passed     = true;
+
+    for ( int topology = Filter::BIQUAD; topology <= Filter::SVF; ++topology )
+    for ( float resonance : resonances )
+    {
+        std::vector<float> exact = noise, ramped = noise;
+
+        double exactTime  = render( exact,  frames, ( Filter::Topology ) topology, resonance, 1 );
+        double rampedTime = render( ramped, frames, ( Filter::Topology ) topology, resonance, controlRate );
+
+        float peak = 0.f, deviation = 0.f;
+        for ( size_t i = 0; i < exact.size(); ++i ) {
+            peak      = fmaxf( peak, fabsf( exact[ i ] ));
+            deviation = fmaxf( deviation, fabsf( exact[ i ] - ramped[ i ] ));
+        }
+        float deviationDB = 20.f * log10f( fmaxf( deviation, 1e-9f ) / peak );
+
+        printf( "%-6s resonance %.1f, control rate 1: %6.1f ms, control rate %d: %6.1f ms, max. deviation %6.1f dB\n",
+                names[ topology ], resonance, exactTime, controlRate, rampedTime, deviationDB );
+
+        if ( deviationDB > MAX_DEVIATION_DB ) {
+            printf( "%-6s deviation exceeds %.1f dB\n", names[ topology ], MAX_DEVIATION_DB );
+            passed = false;
+        }
+    }
+    return passed ? EXIT_SUCCESS : EXIT_FAILURE;
+}